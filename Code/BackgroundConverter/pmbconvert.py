@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Converts PocketMage sleep screen backgrounds to the compressed .pmb format.
+
+Input is either an image2cpp .bin (raw 1bpp, 320x240, inverted so 1 = black) or,
+with Pillow installed, any image Pillow can open (dark pixels become black).
+
+.pmb layout: b"PMB1", uint16 LE width, uint16 LE height, then the 1bpp rows
+(MSB first, 1 = black, rows padded to whole bytes) compressed with PackBits.
+Copy the result to /assets/backgrounds on the SD card.
+"""
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+WIDTH = 320
+HEIGHT = 240
+MAGIC = b"PMB1"
+
+
+def packbits(data: bytes) -> bytes:
+    """PackBits: n < 128 -> n + 1 literals, n > 128 -> next byte repeated 257 - n times."""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        # Run of identical bytes
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out.append(257 - run)
+            out.append(data[i])
+            i += run
+            continue
+
+        # Literals until the next run of 2 or more
+        start = i
+        while i < n and i - start < 128:
+            if i + 1 < n and data[i] == data[i + 1]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return bytes(out)
+
+
+def unpackbits(data: bytes, size: int) -> bytes:
+    """Reference decoder, used to check the output."""
+    out = bytearray()
+    i = 0
+    while len(out) < size and i < len(data):
+        header = data[i]
+        i += 1
+        if header == 128:
+            continue
+        if header < 128:
+            out += data[i:i + header + 1]
+            i += header + 1
+        else:
+            out += bytes([data[i]]) * (257 - header)
+            i += 1
+    return bytes(out)
+
+
+def load_bin(path: Path, width: int, height: int) -> bytes:
+    raw = path.read_bytes()
+    size = (width + 7) // 8 * height
+    if len(raw) < size:
+        sys.exit(f"{path}: expected at least {size} bytes for {width}x{height}, got {len(raw)}")
+    return raw[:size]
+
+
+def load_image(path: Path, threshold: int, invert: bool):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("Pillow is needed for image input: pip install pillow")
+
+    img = Image.open(path).convert("L")
+    if img.width > WIDTH or img.height > HEIGHT:
+        img.thumbnail((WIDTH, HEIGHT))
+    row_bytes = (img.width + 7) // 8
+    bits = bytearray(row_bytes * img.height)
+    pixels = img.load()
+    for y in range(img.height):
+        for x in range(img.width):
+            black = pixels[x, y] < threshold
+            if black != invert:
+                bits[y * row_bytes + x // 8] |= 0x80 >> (x % 8)
+    return bytes(bits), img.width, img.height
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", type=Path, nargs="+", help=".bin or image files")
+    parser.add_argument("-o", "--out-dir", type=Path, help="output folder (default: next to input)")
+    parser.add_argument("--threshold", type=int, default=128, help="gray level below which a pixel is black")
+    parser.add_argument("--invert", action="store_true", help="swap black and white")
+    args = parser.parse_args()
+
+    for path in args.input:
+        if path.suffix.lower() == ".bin":
+            bits, width, height = load_bin(path, WIDTH, HEIGHT), WIDTH, HEIGHT
+            if args.invert:
+                bits = bytes(b ^ 0xFF for b in bits)
+        else:
+            bits, width, height = load_image(path, args.threshold, args.invert)
+
+        packed = packbits(bits)
+        assert unpackbits(packed, len(bits)) == bits
+
+        out_dir = args.out_dir or path.parent
+        out_dir.mkdir(parents=True, exist_ok=True)
+        out = out_dir / (path.stem + ".pmb")
+        out.write_bytes(MAGIC + struct.pack("<HH", width, height) + packed)
+        print(f"{path} -> {out}: {width}x{height}, {len(bits)} -> {len(packed) + 8} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
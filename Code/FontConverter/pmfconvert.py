@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""
+Converts Adafruit GFX font headers (fontconvert output) to PocketMage .pmf font packs.
+
+.pmf layout, little endian:
+  b"PMF1", uint8 first, uint8 last, uint8 yAdvance, uint8 0, uint32 bitmap bytes
+  (last - first + 1) glyphs of uint16 bitmapOffset, uint8 width, uint8 height,
+  uint8 xAdvance, int8 xOffset, int8 yOffset, uint8 0
+  the glyph bitmaps, exactly as in the header
+Copy the result to /assets/fonts on the SD card. A file named like a font the text app uses
+(e.g. FreeSerif9pt8b.pmf) replaces that face and size; see HOWTOADDFONTS.txt on the card.
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = b"PMF1"
+
+
+def parse_header(path: Path):
+    text = re.sub(r"//[^\n]*", "", path.read_text())
+
+    bitmaps = re.search(r"uint8_t\s+\w+\s*\[\s*\]\s*PROGMEM\s*=\s*\{(.*?)\}", text, re.S)
+    glyphs = re.search(r"GFXglyph\s+\w+\s*\[\s*\]\s*PROGMEM\s*=\s*\{(.*)\}\s*;", text[:text.rfind("GFXfont")], re.S)
+    font = re.search(r"GFXfont\s+(\w+)\s*PROGMEM\s*=\s*\{(.*?)\}\s*;", text, re.S)
+    if not (bitmaps and glyphs and font):
+        sys.exit(f"{path}: not an Adafruit GFX font header")
+
+    bitmap = bytes(int(v, 16) for v in re.findall(r"0x([0-9A-Fa-f]{1,2})", bitmaps.group(1)))
+    table = [tuple(int(v) for v in g.split(","))
+             for g in re.findall(r"\{([-\d\s,]+)\}", glyphs.group(1))]
+    first, last, y_advance = (int(v, 0) for v in font.group(2).split(",")[-3:])
+    if len(table) != last - first + 1:
+        sys.exit(f"{path}: {len(table)} glyphs for range 0x{first:02X}-0x{last:02X}")
+    return font.group(1), first, last, y_advance, table, bitmap
+
+
+def to_pmf(first, last, y_advance, table, bitmap) -> bytes:
+    out = bytearray(MAGIC + struct.pack("<BBBBI", first, last, y_advance, 0, len(bitmap)))
+    for offset, width, height, x_advance, x_offset, y_offset in table:
+        out += struct.pack("<HBBBbbB", offset, width, height, x_advance, x_offset, y_offset, 0)
+    return bytes(out + bitmap)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", type=Path, nargs="+", help="GFX font .h files")
+    parser.add_argument("-o", "--out-dir", type=Path, help="output folder (default: next to input)")
+    args = parser.parse_args()
+
+    for path in args.input:
+        name, first, last, y_advance, table, bitmap = parse_header(path)
+        out_dir = args.out_dir or path.parent
+        out_dir.mkdir(parents=True, exist_ok=True)
+        out = out_dir / (name + ".pmf")
+        data = to_pmf(first, last, y_advance, table, bitmap)
+        out.write_bytes(data)
+        print(f"{path} -> {out}: 0x{first:02X}-0x{last:02X}, {len(data)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
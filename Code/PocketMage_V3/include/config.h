@@ -20,7 +20,26 @@
 #define SET_CLOCK_ON_UPLOAD false               // Should system clock be set automatically on code upload?
 #define TOUCH_TIMEOUT_MS 1200                   // Delay after scrolling to return to typing mode (ms)
 #define SYS_METADATA_FILE "/sys/SDMMC_META.txt" // File path to the file system metadata file
+#define BACKGROUNDS_DIR "/assets/backgrounds"   // Custom sleep screens (.bin / .pmb / .bmp / .pbm / .pgm)
+#define BACKGROUND_INDEX_FILE "/sys/backgrounds.idx" // Cached listing of BACKGROUNDS_DIR
+#define FONTS_DIR "/assets/fonts"               // Font packs (.pmf) for the text app
 #define POWER_SAVE_FREQ 40                      // CPU freq for power save mode
+#define TXT_DOC_CACHE_KB 96                     // RAM budget for notes kept open in the text app (KB)
+#define TXT_DOC_CACHE_PSRAM_KB 1024             // Same budget when PSRAM is available (KB)
+#define TXT_LAYOUT_CACHE_FILES 32               // Layout caches kept in /sys/layout, oldest removed first
+#define EINK_GLYPH_CACHE_KB 32                  // RAM for pre-rotated e-ink text glyphs (KB)
+#define ASSET_CACHE_KB 40                       // RAM for decompressed full-screen images (KB)
+#define FONT_CACHE_KB 96                        // RAM for fonts loaded from FONTS_DIR (KB)
+#define FONT_CACHE_PSRAM_KB 512                 // Same budget when PSRAM is available (KB)
+#define EINK_COALESCE_MS 30                     // Redraw requests this close together share one e-ink pass
+#define EINK_IDLE_REDRAW_MS 250                 // Delay before an idle-priority e-ink pass (ms)
+#define EINK_SPI_BAND_ROWS 16                   // E-ink image rows written per SPI lease; OLED frames go out in between
+#define OLED_TOAST_MS 1000                      // How long OLED().toast() messages stay up (ms)
+#define EINK_PARTIAL_MAX_PERCENT 50             // Changed areas larger than this share of the screen get a full refresh
+#define EINK_GHOST_TILE 40                      // Ghosting is tracked per square tile of this many panel pixels
+#define EINK_GHOST_UPDATE_POINTS 4              // Ghost score a partial update adds to each tile it covers
+#define EINK_GHOST_FLIP_PIXELS 64               // Plus one point per this many pixels flipped in the tile
+#define EINK_GHOST_BUDGET 16                    // Tile budget in points per FULL_REFRESH_AFTER step
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////|
 
 // PIN DEFINITION
@@ -16,7 +16,7 @@ extern Preferences prefs;                       // NVS preferencesv
 extern TaskHandle_t einkHandlerTaskHandle;      // E-Ink handler task
 extern int OLEDFPSMillis;                       // Last OLED FPS update time
 extern int KBBounceMillis;                      // Last keyboard debounce time
-extern volatile bool newState;                  // App state changed
+extern RedrawFlag newState;                     // App state changed, wakes the e-ink task
 extern volatile bool disableTimeout;            // Disable timeout globally
 extern bool fileLoaded;     
 extern unsigned int flashMillis;                // Flash timing
@@ -76,6 +76,9 @@ void TXT_INIT_JournalMode();
 void processKB_TXT_NEW();
 void einkHandler_TXT_NEW();
 void saveMarkdownFile(const String& path);
+void flushOpenDocuments();
+void dropOpenDocuments();
+void notesChanging(const String& path);
 
 // <HOME.cpp>
 void HOME_INIT();
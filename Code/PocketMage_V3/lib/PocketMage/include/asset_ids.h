@@ -0,0 +1,58 @@
+#pragma once
+// Generated by tools/pack_assets.py from assets/manifest.csv, do not edit
+#include <stdint.h>
+
+enum AssetId : uint16_t {
+  ASSET_SCREENSAVER0,
+  ASSET_SCREENSAVER1,
+  ASSET_SCREENSAVER2,
+  ASSET_SCREENSAVER3,
+  ASSET_SCREENSAVER4,
+  ASSET_SCREENSAVER5,
+  ASSET_SCREENSAVER6,
+  ASSET_SCREENSAVER7,
+  ASSET_SCREENSAVER8,
+  ASSET_SCREENSAVER9,
+  ASSET_SCREENSAVER10,
+  ASSET_SCREENSAVER11,
+  ASSET_SCREENSAVER12,
+  ASSET_SCREENSAVER13,
+  ASSET_SCREENSAVER14,
+  ASSET_SCREENSAVER15,
+  ASSET_SCREENSAVER16,
+  ASSET_SCREENSAVER17,
+  ASSET_SLEEP0,
+  ASSET_FILEWIZ0,
+  ASSET_FILEWIZ1,
+  ASSET_FILEWIZ2,
+  ASSET_FILEWIZ3,
+  ASSET_FILEWIZ_LITE0,
+  ASSET_FILEWIZ_LITE1,
+  ASSET_FILEWIZ_LITE2,
+  ASSET_FILEWIZ_LITE3,
+  ASSET_FONT_PICKER,
+  ASSET_NOW_LATER0,
+  ASSET_NOW_LATER1,
+  ASSET_NOW_LATER2,
+  ASSET_NOW_LATER3,
+  ASSET_TASKS0,
+  ASSET_TASKS1,
+  ASSET_SETTINGS,
+  ASSET_CALENDAR00,
+  ASSET_CALENDAR01,
+  ASSET_CALENDAR02,
+  ASSET_CALENDAR03,
+  ASSET_CALENDAR04,
+  ASSET_CALENDAR05,
+  ASSET_CALENDAR06,
+  ASSET_CALENDAR07,
+  ASSET_CALENDAR08,
+  ASSET_CALENDAR09,
+  ASSET_CALENDAR10,
+  ASSET_LEXICON0,
+  ASSET_LEXICON1,
+  ASSET_USB,
+  ASSET_JOURNAL,
+  ASSET_APP_LOADER,
+  ASSET_COUNT
+};
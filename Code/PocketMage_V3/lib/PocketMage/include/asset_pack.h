@@ -0,0 +1,62 @@
+#pragma once
+#include <Arduino.h>
+#include <GxEPD2_BW.h>
+#include <vector>
+#include <asset_ids.h>
+
+// ===================== ASSET PACK =====================
+// Full-screen e-ink images live compressed in one flash blob built from assets/manifest.csv
+// by tools/pack_assets.py (run automatically before each PlatformIO build). Add an image by
+// dropping its image2cpp .bin in assets/eink and listing it in the manifest; small icons and
+// animation frames stay as plain PROGMEM arrays in assets.cpp / libAssets.cpp.
+
+// Must match tools/pack_assets.py
+enum AssetFormat : uint8_t {
+  ASSET_RAW,             // Bitmap as is, drawn straight from flash
+  ASSET_PACKBITS,        // PackBits
+  ASSET_PACKBITS_DELTA   // PackBits of each row XORed with the row above
+};
+
+struct AssetEntry {
+  uint32_t offset;   // Into ASSET_DATA
+  uint32_t size;     // Stored bytes, 0 if left out of this build
+  uint16_t width;
+  uint16_t height;
+  uint8_t  format;   // AssetFormat
+};
+
+extern const AssetEntry ASSET_INDEX[ASSET_COUNT];
+extern const uint8_t    ASSET_DATA[];
+
+// Decompressed images, least recently used dropped first once over ASSET_CACHE_KB.
+// Used from whichever task draws to the display, like the display itself, so no locking.
+class AssetCache {
+public:
+  // 1bpp bitmap for drawBitmap, nullptr if the id is unknown, not in this build or out of
+  // memory. Stays valid until the next get() or draw() of another asset.
+  const uint8_t* get(uint16_t id);
+  // Draws the asset at (x, y); false if get() would return nullptr
+  bool     draw(uint16_t id, int16_t x, int16_t y, Adafruit_GFX& gfx,
+                uint16_t color = GxEPD_BLACK);
+  uint16_t width(uint16_t id) const;
+  uint16_t height(uint16_t id) const;
+  void     clear();
+  size_t   bytes() const { return bytes_; }
+
+private:
+  struct Cached {
+    uint16_t id;
+    uint32_t lastUse;
+    uint8_t* data;
+    size_t   size;
+  };
+
+  bool unpack_(const AssetEntry& entry, uint8_t* dst, size_t size) const;
+  void evict_(size_t need);
+
+  std::vector<Cached> cached_;
+  size_t              bytes_   = 0;
+  uint32_t            useTick_ = 0;
+};
+
+AssetCache& ASSETS();
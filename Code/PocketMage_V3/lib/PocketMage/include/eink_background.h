@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// ===================== BACKGROUNDS =====================
+// Custom sleep screens in BACKGROUNDS_DIR, either:
+//  .bin  raw 1bpp 320x240 from image2cpp (inverted, 1 = black), 9600 bytes
+//  .pmb  "PMB1", uint16 LE width, uint16 LE height, then the same rows PackBits-compressed.
+//        Made with Code/BackgroundConverter/pmbconvert.py
+//  .bmp / .pbm / .pgm  any size, scaled and dithered by drawImageFile()
+// All are streamed from the card a strip of rows at a time.
+
+// Name of a random background file, "" if there are none. The folder is listed once into
+// BACKGROUND_INDEX_FILE and picked from there until invalidateBackgroundIndex().
+String pickBackground();
+// Call after anything that may have added, removed or renamed backgrounds
+void   invalidateBackgroundIndex();
+// Draws the file in black at (0, 0); false if it is missing or malformed
+bool   drawBackgroundFile(const String& path, Adafruit_GFX& gfx);
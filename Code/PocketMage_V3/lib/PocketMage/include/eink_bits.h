@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ===================== EINK BITS =====================
+// Bit twiddling on 1bpp panel buffers (rows of bytes, MSB first), used by EinkCanvas. Kept free
+// of Arduino so the native tests build the same code the device runs.
+
+// Transpose an 8x8 bit block (Hacker's Delight 7-3): out[k] holds column k, row 0 in the MSB
+inline void transpose8(const uint8_t in[8], uint8_t out[8]) {
+  uint32_t x = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+  uint32_t y = ((uint32_t)in[4] << 24) | ((uint32_t)in[5] << 16) | ((uint32_t)in[6] << 8) | in[7];
+  uint32_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+
+  out[0] = x >> 24; out[1] = x >> 16; out[2] = x >> 8; out[3] = x;
+  out[4] = y >> 24; out[5] = y >> 16; out[6] = y >> 8; out[7] = y;
+}
+
+// Rows and byte columns, inclusive, of the bytes that differ between two buffers
+struct BitsDiff {
+  int16_t rowMin, rowMax, colMin, colMax;
+  bool empty() const { return rowMax < 0; }
+};
+
+// Compares bytes (a multiple of 4) of two word-aligned buffers with stride bytes per row.
+// tileFlips, if given, gets the count of differing pixels added per tile x tile square
+// (tile a multiple of 8), tileCols tiles per row.
+inline BitsDiff diffBits(const uint8_t* bufA, const uint8_t* bufB, size_t bytes, uint16_t stride,
+                         uint16_t tile = 8, uint8_t tileCols = 0, uint16_t* tileFlips = nullptr) {
+  // XOR a word at a time; rows need not be a whole number of words, so only words that differ
+  // are split back into row and byte column
+  const uint32_t* a = (const uint32_t*)bufA;
+  const uint32_t* b = (const uint32_t*)bufB;
+  BitsDiff d = { INT16_MAX, -1, INT16_MAX, -1 };
+  for (size_t i = 0; i < bytes / 4; i++) {
+    const uint32_t x = a[i] ^ b[i];
+    if (!x) continue;
+
+    const uint8_t* diffBytes = (const uint8_t*)&x;
+    for (uint8_t k = 0; k < 4; k++) {
+      if (!diffBytes[k]) continue;
+      const int16_t row = (i * 4 + k) / stride;
+      const int16_t col = (i * 4 + k) % stride;
+      if (row < d.rowMin) d.rowMin = row;
+      if (row > d.rowMax) d.rowMax = row;
+      if (col < d.colMin) d.colMin = col;
+      if (col > d.colMax) d.colMax = col;
+      if (tileFlips)
+        tileFlips[(row / tile) * tileCols + col * 8 / tile] += __builtin_popcount(diffBytes[k]);
+    }
+  }
+  return d;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <vector>
+#include <pocketmage_eink.h> // EinkRect
+
+// ===================== GLYPH CACHE =====================
+// GFXfont glyphs unpacked once and stored rotated into the panel's native orientation
+// (one row per glyph column), so text is blitted a byte at a time instead of pixel by pixel.
+struct CachedGlyph {
+  uint16_t offset;    // Into the font's glyph data
+  uint8_t  rows;      // Glyph width, one native row per column
+  uint8_t  rowBytes;  // Bytes per row
+  uint8_t  bits;      // Glyph height, bits used per row
+  int8_t   xOffset;
+  int8_t   yOffset;
+  uint8_t  xAdvance;
+  bool     cached;
+};
+
+class EinkGlyphCache {
+public:
+  // Returns nullptr if c is not in the font or there is no memory for it
+  const CachedGlyph* get(const GFXfont* font, uint8_t c, const uint8_t** bitmap);
+  void   clear();
+  // Drops font's glyphs; called before a loaded font is freed, as another may reuse its address
+  void   forget(const GFXfont* font);
+  size_t bytes() const { return bytes_; }
+
+private:
+  struct FontGlyphs {
+    const GFXfont*           font;
+    uint32_t                 lastUse;
+    std::vector<CachedGlyph> glyphs;  // Indexed by c - font->first
+    std::vector<uint8_t>     data;
+  };
+
+  FontGlyphs* fontGlyphs_(const GFXfont* font);
+  void        evict_(const FontGlyphs* keep);
+
+  std::vector<FontGlyphs> fonts_;
+  size_t                  bytes_   = 0;
+  uint32_t                useTick_ = 0;
+};
+
+// ===================== EINK CANVAS =====================
+// Off-screen page in the panel's native layout (same bytes GxEPD2 sends to the controller),
+// presented with rotation 3 like the display. Pushed with EINK().refresh(canvas).
+// Rects, lines and 1bpp bitmaps are converted to panel coordinates once per call and written
+// a byte at a time; only what Adafruit_GFX draws pixel by pixel goes through drawPixel.
+class EinkCanvas : public Adafruit_GFX {
+public:
+  EinkCanvas();
+  ~EinkCanvas();
+
+  void   drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void   fillScreen(uint16_t color) override;
+  void   fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void   drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void   drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void   writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void   writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void   writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Logical-orientation 1bpp bitmaps (Adafruit_GFX layout), transposed 8x8 bits at a time
+  using Adafruit_GFX::drawBitmap;
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                  uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                  uint16_t color, uint16_t bg);
+  // Bitmaps already in panel layout (see rotateToNative), placed at native (nx, ny)
+  void drawNativeBitmap(int16_t nx, int16_t ny, const uint8_t bitmap[], int16_t nw, int16_t nh,
+                        uint16_t color);
+  void drawNativeBitmap(int16_t nx, int16_t ny, const uint8_t bitmap[], int16_t nw, int16_t nh,
+                        uint16_t color, uint16_t bg);
+  // Rotate a w x h logical bitmap once into panel layout (h x w, (h + 7) / 8 bytes per row)
+  static void rotateToNative(const uint8_t src[], int16_t w, int16_t h, uint8_t* dst);
+
+  void           copyFrom(const EinkCanvas& other);
+  // Byte-aligned panel-coordinate box around every pixel that differs from other, empty if none.
+  // tileFlips, if given, gets the count of differing pixels added per EINK_GHOST_TILE tile.
+  EinkRect       diff(const EinkCanvas& other, uint16_t* tileFlips = nullptr) const;
+  uint8_t*       getBuffer()       { return buffer_; }
+  const uint8_t* getBuffer() const { return buffer_; }
+
+  static constexpr uint16_t NATIVE_WIDTH  = 240;
+  static constexpr uint16_t NATIVE_HEIGHT = 320;
+  static constexpr uint16_t STRIDE        = NATIVE_WIDTH / 8;
+  static constexpr size_t   BUFFER_BYTES  = (size_t)STRIDE * NATIVE_HEIGHT;
+
+private:
+  void blitGlyph_(const CachedGlyph& g, const uint8_t* bitmap, int16_t x, int16_t y);
+  void fillNative_(int16_t nx, int16_t ny, int16_t nw, int16_t nh, bool white);
+  void writeBits_(int16_t nx, int16_t ny, uint8_t bits, uint8_t mask, uint16_t color,
+                  uint16_t bg, bool opaque);
+  void blitBitmap_(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                   uint16_t color, uint16_t bg, bool opaque);
+  void blitNative_(int16_t nx, int16_t ny, const uint8_t bitmap[], int16_t nw, int16_t nh,
+                   uint16_t color, uint16_t bg, bool opaque);
+
+  uint8_t* buffer_ = nullptr;
+};
+
+EinkGlyphCache& GLYPHS();
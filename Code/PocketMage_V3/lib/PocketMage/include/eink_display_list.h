@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <vector>
+#include <functional>
+
+// What the e-ink task does with the buffer once a display list has been replayed
+enum EinkCommit : uint8_t {
+  COMMIT_NONE,       // Leave it for the app's next e-ink pass
+  COMMIT_REFRESH,    // EINK().refresh()
+  COMMIT_SLOW_FULL   // EINK().refresh() with a slow full update
+};
+
+// ===================== DISPLAY LIST =====================
+// Draw commands recorded on any core and replayed by the e-ink task, so input handling never
+// waits on SPI or the panel and the display buffer is only written from one core.
+// Record, then hand it over with EINK().submit(std::move(list)).
+class EinkDisplayList {
+public:
+  using Draw = std::function<void(Adafruit_GFX&)>;
+
+  void fillScreen(uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  // The bitmap is not copied and must stay valid until the list has been replayed
+  void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h,
+                  uint16_t color);
+  void text(int16_t x, int16_t y, const GFXfont* font, const String& s, uint16_t color);
+  // Anything else; runs on the e-ink task
+  void draw(Draw fn);
+  void commit(EinkCommit how = COMMIT_REFRESH) { commit_ = how; }
+
+  EinkCommit getCommit() const { return commit_; }
+  bool       empty() const     { return ops_.empty() && commit_ == COMMIT_NONE; }
+  void       replay(Adafruit_GFX& gfx) const;
+
+private:
+  enum OpType : uint8_t { OP_FILL_SCREEN, OP_FILL_RECT, OP_DRAW_RECT, OP_LINE, OP_BITMAP,
+                          OP_TEXT, OP_DRAW };
+  struct Op {
+    OpType      type;
+    int16_t     x, y, w, h;   // Rect, line end points (w, h = x1, y1) or bitmap size
+    uint16_t    color;
+    const void* data;         // Bitmap or font; index into draws_ for OP_DRAW
+  };
+
+  std::vector<Op>     ops_;
+  std::vector<String> text_;   // OP_TEXT strings, in order
+  std::vector<Draw>   draws_;
+  EinkCommit          commit_ = COMMIT_NONE;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// ===================== IMAGES =====================
+// Pictures read straight off the card, with no conversion step:
+//  .bmp  uncompressed 1, 4, 8, 16, 24 or 32 bit, bottom-up or top-down
+//  .pbm  P1 / P4
+//  .pgm  P2 / P5, 8 or 16 bit samples
+// Any size is fine. Rows are decoded one at a time and box-filtered (or stretched) to fit
+// 320x240 without changing the aspect ratio. Each output row is dithered to black and white as
+// soon as it is complete, so a few KB of row buffers are all the RAM a picture ever takes.
+
+enum ImageDither : uint8_t {
+  DITHER_FLOYD_STEINBERG,   // Error diffusion, best for photos
+  DITHER_ORDERED,           // 8x8 Bayer matrix, steadier on flat areas and line art
+};
+
+// True for the extensions drawImageFile() reads
+bool isImageFile(const String& path);
+// Draws the image's black pixels centred in the 320x240 screen; false if it is missing,
+// unsupported or truncated (rows already drawn stay drawn)
+bool drawImageFile(const String& path, Adafruit_GFX& gfx, ImageDither dither = DITHER_FLOYD_STEINBERG);
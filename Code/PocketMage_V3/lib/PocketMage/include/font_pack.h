@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <vector>
+
+// ===================== FONT PACKS =====================
+// GFX fonts loaded from FONTS_DIR/<name>.pmf (made with Code/FontConverter/pmfconvert.py)
+// instead of being compiled in. A font is loaded whole the first time it is used, since
+// Adafruit_GFX indexes its glyph and bitmap arrays directly, and stays at the same address for
+// as long as the firmware runs, so its GFXfont* can be kept and compared.
+//
+// Loaded fonts count against FONT_CACHE_KB (FONT_CACHE_PSRAM_KB with PSRAM). trim() unloads the
+// least recently used ones over budget, but only fonts that have not been used since the
+// previous trim(): call it once per redraw, and never hold a font across two calls without
+// calling use() again. An unloaded font reads as empty (nothing drawn) until use() reloads it.
+class FontPack {
+public:
+  // Slot for FONTS_DIR/<name>.pmf, -1 if the card has no such file. Nothing is read yet;
+  // a known name keeps its slot and is simply retried on the next use().
+  int            find(const char* name);
+  // The font, loaded if needed; nullptr if the file is missing, malformed or out of memory
+  const GFXfont* use(int slot);
+  void           trim();
+  // Unloads everything, e.g. after the card was changed over USB
+  void           clear();
+  size_t         bytes() const { return bytes_; }
+
+private:
+  struct Slot {
+    String   name;
+    GFXfont  font;
+    uint8_t* data;      // Glyph table then bitmap, one allocation
+    size_t   size;
+    uint32_t lastUse;
+    bool     failed;    // Do not retry a file that did not load
+  };
+
+  bool load_(Slot& slot);
+  void unload_(Slot& slot);
+
+  std::vector<Slot*> slots_;   // Never freed, so GFXfont addresses stay valid
+  SemaphoreHandle_t  lock_     = nullptr;   // The layout worker and the e-ink task both use fonts
+  size_t             bytes_    = 0;
+  uint32_t           useTick_  = 0;
+  uint32_t           lastTrim_ = 0;
+};
+
+FontPack& FONTS();
@@ -2,6 +2,7 @@
 #include <Arduino.h>
 #include <Adafruit_GFX.h>
 #include <vector>
+#include <array>
 #include <GxEPD2_BW.h>
 
 // ===================== FRAME CLASS =====================
@@ -20,6 +21,8 @@ struct TextSource {
   virtual ~TextSource() {}
   virtual size_t   size() const = 0;
   virtual LineView line(size_t i) const = 0; 
+  // changes whenever the lines do, so frames know to re-wrap and redraw
+  virtual uint32_t revision() const { return 0; }
 };
 template<size_t MAX_LINES, size_t BUF_BYTES>
 struct FixedArenaSource : TextSource {
@@ -29,6 +32,7 @@ struct FixedArenaSource : TextSource {
   uint8_t  flags_[MAX_LINES];
   size_t   nLines = 0;
   size_t   used   = 0;
+  uint32_t rev    = 0;
 
   size_t size() const override { return nLines; }
 
@@ -36,7 +40,9 @@ struct FixedArenaSource : TextSource {
     return { buf + off[i], len_[i], flags_[i] };
   }
 
-  void clear() { nLines = 0; used = 0; }
+  uint32_t revision() const override { return rev; }
+
+  void clear() { nLines = 0; used = 0; rev++; }
 
   // Returns false if out of capacity; caller can choose to drop the oldest, etc.
   bool pushLine(const char* s, uint16_t L, uint8_t flags = LF_NONE) {
@@ -48,26 +54,81 @@ struct FixedArenaSource : TextSource {
     flags_[nLines]= flags;
     used         += L + 1;
     nLines++;
+    rev++;
     return true;
   }
 };
+// growable arena, allocated on the first pushLine (in PSRAM when there is some) and capped at
+// maxLines / maxBytes; release() gives the memory back when no frame shows it
+class ArenaSource : public TextSource {
+public:
+  explicit ArenaSource(size_t maxLines = 512, size_t maxBytes = 16384)
+  : maxLines_(maxLines), maxBytes_(maxBytes) {}
+  ~ArenaSource() { release(); }
+
+  size_t   size() const override     { return nLines_; }
+  LineView line(size_t i) const override;
+  uint32_t revision() const override { return rev_; }
+
+  void clear() { nLines_ = 0; used_ = 0; rev_++; }
+  void release();
+  // Returns false if out of capacity or memory; caller can choose to drop the oldest, etc.
+  bool pushLine(const char* s, uint16_t L, uint8_t flags = LF_NONE);
+
+private:
+  struct Entry { uint32_t off; uint16_t len; uint8_t flags; };
+  bool reserve_(size_t lines, size_t bytes);
+
+  char*    buf_      = nullptr;
+  Entry*   entries_  = nullptr;
+  size_t   bufCap_   = 0;
+  size_t   lineCap_  = 0;
+  size_t   nLines_   = 0;
+  size_t   used_     = 0;
+  uint32_t rev_      = 0;
+  size_t   maxLines_;
+  size_t   maxBytes_;
+};
+
+// lengths of string literals at compile time, for ProgmemTableSource
+template<size_t... N>
+constexpr std::array<uint16_t, sizeof...(N)> textLengths(const char (&... text)[N]) {
+  return {{ (uint16_t)(N - 1)... }};
+}
+
 struct ProgmemTableSource : TextSource {
   // table is a PROGMEM array of PROGMEM pointers to '\0'-terminated strings
   const char* const* table; // PROGMEM
   size_t count;
+  const uint16_t* lens;     // PROGMEM, optional; measured once on first use when missing
 
-  ProgmemTableSource(const char* const* t, size_t n) : table(t), count(n) {}
+  ProgmemTableSource(const char* const* t, size_t n, const uint16_t* l = nullptr)
+  : table(t), count(n), lens(l) {}
 
   size_t size() const override { return count; }
 
   LineView line(size_t i) const override {
     const char* p = (const char*)pgm_read_ptr(&table[i]);
-    // length from PROGMEM
-    uint16_t L = (uint16_t)strlen_P(p);
-    return { p, L, LF_NONE };
+    if (lens) return { p, pgm_read_word(&lens[i]), LF_NONE };
+    if (measured.size() != count) {
+      measured.resize(count);
+      for (size_t j = 0; j < count; ++j)
+        measured[j] = (uint16_t)strlen_P((const char*)pgm_read_ptr(&table[j]));
+    }
+    return { p, measured[i], LF_NONE };
   }
+
+private:
+  mutable std::vector<uint16_t> measured;
 };
 
+// defines ProgmemTableSource name over the given string literals, lengths computed at compile time
+#define PROGMEM_TEXT_SOURCE(name, ...)                                                        \
+  static const char* const name##_table[] PROGMEM = { __VA_ARGS__ };                          \
+  static constexpr auto    name##_lens PROGMEM   = textLengths(__VA_ARGS__);                  \
+  ProgmemTableSource name(name##_table, sizeof(name##_table) / sizeof(name##_table[0]),      \
+                          name##_lens.data())
+
 extern const char* const HELP_LINES[] PROGMEM;
 extern const size_t HELP_COUNT;
 extern const char* const UNIT_TYPES_LINES[] PROGMEM;
@@ -104,7 +165,7 @@ extern const char* const CONV_FREQUENCY_LINES[] PROGMEM;
 extern const size_t CONV_FREQUENCY_COUNT;
 
 
-extern FixedArenaSource<512, 16384> frameLines;
+extern ArenaSource frameLines;
 extern ProgmemTableSource helpSrc;
 
 
@@ -140,6 +201,30 @@ public:
   const uint8_t* bitmap    = nullptr;  // for bitmap frames
   const GFXfont *font = (GFXfont *)&FreeSerif9pt7b;
 
+  // wrap points of every source line seen so far, reused while width, font and source hold
+  struct Wraps { int32_t first = -1; uint16_t count = 0; uint16_t len = 0; };  // into wrapStarts
+  std::vector<Wraps>    wraps;
+  std::vector<uint16_t> wrapStarts;
+  const TextSource*     wrapSource   = nullptr;
+  uint32_t              wrapRevision = 0;
+  const GFXfont*        wrapFont     = nullptr;
+  int                   wrapWidth    = -1;
+
+  // retained state, kept by einkFramesDynamic so only what changed is redrawn
+  struct Row { uint16_t line; uint16_t pos; uint16_t len; };  // slice of a source line
+  std::vector<Row>  rows;                     // wrapped visible rows, top to bottom
+  bool              dirty        = true;      // redraw the whole frame next time
+  const TextSource* rowsSource   = nullptr;   // what rows was wrapped from
+  uint32_t          rowsRevision = 0;
+  const GFXfont*    rowsFont     = nullptr;
+  long              rowsStart    = -1;
+  long              rowsEnd      = -1;
+  int               rowsWidth    = -1;
+  const uint8_t*    drawnBitmap  = nullptr;   // as last drawn
+  int               drawnChoice  = -1;
+  bool              drawnCurrent = false;     // was CurrentFrameState
+  int               drawnLeft = -1, drawnRight = -1, drawnTop = -1, drawnBottom = -1;
+
   
   // base constructor for common fields
   Frame(int left, int right, int top, int bottom, 
@@ -169,6 +254,8 @@ public:
 
   bool hasText()   const { return kind == Kind::text   && source; }
   bool hasBitmap() const { return kind == Kind::bitmap && bitmap; }
+  // for changes frames can't see, e.g. a TextSource without revision() edited in place
+  void markDirty() { dirty = true; }
 };
 
 extern Frame testBitmapScreen;
@@ -185,7 +272,6 @@ extern std::vector<Frame*> frames;
   // main functions
 void einkFramesDynamic(std::vector<Frame*> &frames, bool doFull_);
   // text boxes
-std::vector<String> formatText(Frame &frame,int maxTextWidth);
 void drawLineInFrame(String &srcLine, int lineIndex, Frame &frame, int usableY, bool clearLine, bool isPartial);
 void drawFrameBox(int usableX, int usableY, int usableWidth, int usableHeight,bool invert);
 int computeCursorX(Frame &frame, bool rightAlign, bool centerAlign, int16_t x1, uint16_t lineWidth);
@@ -14,29 +14,9 @@ extern const unsigned char* batt_allArray[6];
 extern const unsigned char scrolloled0 [] PROGMEM;
 
 //
-extern const unsigned char sleep0 [] PROGMEM;
 extern const unsigned char sleep1 [] PROGMEM;
 
 //
-extern const unsigned char _ScreenSaver0 [] PROGMEM;
-extern const unsigned char _ScreenSaver1 [] PROGMEM;
-extern const unsigned char _ScreenSaver2 [] PROGMEM;
-extern const unsigned char _ScreenSaver3 [] PROGMEM;
-extern const unsigned char _ScreenSaver4 [] PROGMEM;
-extern const unsigned char _ScreenSaver5 [] PROGMEM;
-extern const unsigned char _ScreenSaver6 [] PROGMEM;
-extern const unsigned char _ScreenSaver7 [] PROGMEM;
-extern const unsigned char _ScreenSaver8 [] PROGMEM;
-extern const unsigned char _ScreenSaver9 [] PROGMEM;
-extern const unsigned char _ScreenSaver10 [] PROGMEM;
-extern const unsigned char _ScreenSaver11 [] PROGMEM;
-extern const unsigned char _ScreenSaver12 [] PROGMEM;
-extern const unsigned char _ScreenSaver13 [] PROGMEM;
-extern const unsigned char _ScreenSaver14 [] PROGMEM;
-extern const unsigned char _ScreenSaver15 [] PROGMEM;
-extern const unsigned char _ScreenSaver16 [] PROGMEM;
-extern const unsigned char _ScreenSaver17 [] PROGMEM;
-extern const unsigned char* ScreenSaver_allArray[18];
 
 // **** Not implemented
 extern const unsigned char KBStatusKBStatus0 [] PROGMEM; 
@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include <vector>
+
+// ===================== OLED SPRITES =====================
+// Animations for the OLED from XBM frames that all face one way. A clip is decoded once into a
+// RAM atlas holding its first frame, as given and mirrored, followed by only the rows each later
+// frame changes. Frames up to 32 rows tall.
+//
+// A sprite draws itself into u8g2's buffer without clearing anything else. Stepping to the
+// next frame in place redraws just the rows that change; moving or switching clips erases the
+// old frame's pixels and draws the new one. The rest of the scene stays as drawn, and the OLED
+// compositor only has the tiles under those rows to send.
+class SpriteAtlas {
+public:
+  // Adds count w x h XBM frames as a clip, looping from the last frame back to the first;
+  // returns its id, or -1 if the frames are too tall
+  int addClip(const unsigned char* const* frames, uint8_t count, uint8_t w, uint8_t h);
+
+  uint8_t width(int clip) const  { return clips_[clip].width; }
+  uint8_t height(int clip) const { return clips_[clip].height; }
+  uint8_t count(int clip) const  { return clips_[clip].count; }
+
+private:
+  friend class OledSprite;
+
+  struct Clip {
+    uint8_t               width;
+    uint8_t               height;
+    uint8_t               rowBytes;
+    uint8_t               count;
+    std::vector<uint8_t>  first[2];   // Frame 0, facing the source way then mirrored
+    std::vector<uint32_t> changed;    // Per frame, the rows that differ from the frame before
+    std::vector<uint16_t> offset;     // Per frame, where its changed rows start in rows
+    std::vector<uint8_t>  rows[2];    // Changed rows of every frame, source way then mirrored
+  };
+
+  std::vector<Clip> clips_;
+};
+
+class OledSprite {
+public:
+  explicit OledSprite(const SpriteAtlas& atlas) : atlas_(atlas) {}
+
+  // Shows frame of clip with its top left at (x, y), mirrored if flip. Returns the rows it drew
+  // or erased, bit r for row y + r, 0 if that frame was already showing there.
+  uint32_t draw(U8G2& u8, int clip, uint8_t frame, bool flip, int16_t x, int16_t y);
+  // Draws the current frame again over whatever was drawn on top of it
+  void redraw(U8G2& u8);
+  // The buffer was cleared: nothing to erase before the next draw()
+  void reset() { shown_ = false; }
+
+private:
+  void seek_(const SpriteAtlas::Clip& c, uint8_t frame, bool flip);
+  void apply_(const SpriteAtlas::Clip& c, uint8_t frame, bool flip);
+  void blit_(U8G2& u8, uint32_t rows, uint8_t color);
+
+  const SpriteAtlas&   atlas_;
+  std::vector<uint8_t> bitmap_;   // Current frame
+  int                  clip_  = -1;
+  uint8_t              frame_ = 0;
+  bool                 flip_  = false;
+  bool                 shown_ = false;
+  int16_t              x_     = 0;
+  int16_t              y_     = 0;
+};
@@ -1,6 +1,15 @@
 // Pocketmage library headers
 #include <pocketmage_eink.h>
+#include <eink_canvas.h>
+#include <eink_display_list.h>
+#include <eink_background.h>
+#include <eink_image.h>
+#include <asset_pack.h>
+#include <font_pack.h>
+#include <utf8_glyphs.h>
 #include <pocketmage_oled.h>
+#include <oled_sprite.h>
+#include <spi_bus.h>
 #include <pocketmage_sd.h>
 #include <pocketmage_kb.h>
 #include <pocketmage_bz.h>
@@ -10,7 +10,9 @@
 #include <Arduino.h>
 #include <GxEPD2_BW.h>
 #include <vector>
+#include <functional>
 #include <config.h> // for FULL_REFRESH_AFTER
+#include <eink_display_list.h>
 #pragma region fonts
 // FONTS
 // 3x7
@@ -31,18 +33,72 @@
 
 // Type alias for readability
 using PanelT   = GxEPD2_310_GDEQ031T10;
-using DisplayT = GxEPD2_BW<PanelT, PanelT::HEIGHT>;
+
+// Area of the screen in display (rotated) coordinates
+struct EinkRect {
+  int16_t x = 0, y = 0, w = 0, h = 0;
+
+  bool empty() const { return w <= 0 || h <= 0; }
+  void add(int16_t px, int16_t py, int16_t pw, int16_t ph);
+  void merge(const EinkRect& other) { if (!other.empty()) add(other.x, other.y, other.w, other.h); }
+  void alignToBytes();
+  // Same area on the panel (GxEPD2 native coordinates) for a display rotation
+  EinkRect toPanel(uint8_t rotation) const;
+};
+
+// GxEPD2_BW that records the bounding box of everything drawn since the buffer was last cleared,
+// so refresh() can update only that part of the panel
+class PocketmageDisplay : public GxEPD2_BW<PanelT, PanelT::HEIGHT> {
+public:
+  using GxEPD2_BW<PanelT, PanelT::HEIGHT>::GxEPD2_BW;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void setFullWindow();
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  // Counted so EINK() knows when the panel no longer shows the last canvas it sent
+  void display(bool partial_update_mode = false);
+  void displayWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool nextPage();
+
+  const EinkRect& dirty() const      { return dirty_; }
+  void            clearDirty()       { dirty_ = EinkRect(); }
+  uint32_t        panelWrites() const { return panelWrites_; }
+
+private:
+  EinkRect dirty_;
+  bool     partialWindow_ = false;  // fillScreen only clears the window then
+  uint32_t panelWrites_   = 0;
+};
+
+using DisplayT = PocketmageDisplay;
 
 // E-ink display
 extern DisplayT display;
 
+class EinkCanvas;
+
 extern void einkHandler(void *parameter);
 
+// How soon a requested e-ink pass should run
+enum RedrawPriority : uint8_t {
+  REDRAW_NOW,     // Run as soon as the e-ink task is free
+  REDRAW_NORMAL,  // Wait EINK_COALESCE_MS for more requests, then run once
+  REDRAW_IDLE     // Background work, run after EINK_IDLE_REDRAW_MS
+};
+
 // ===================== EINK CLASS =====================
 class PocketmageEink {
 public:
   explicit PocketmageEink(DisplayT& display) : display_(display) {}
 
+  using RefreshDone = std::function<void()>;
+
+  // Ghost budget tiles over the panel
+  static constexpr uint8_t GHOST_COLS  = (PanelT::WIDTH + EINK_GHOST_TILE - 1) / EINK_GHOST_TILE;
+  static constexpr uint8_t GHOST_ROWS  = (PanelT::HEIGHT + EINK_GHOST_TILE - 1) / EINK_GHOST_TILE;
+  static constexpr uint8_t GHOST_TILES = GHOST_COLS * GHOST_ROWS;
+
   // Wire up external buffers/state used to read from globals
   void setLineSpacing(uint8_t lineSpacing)                      { lineSpacing_ = lineSpacing; };               // reference to lineSpacing (default 6)
   void setFullRefreshAfter(uint8_t fullRefreshAfter)  { fullRefreshAfter_ = fullRefreshAfter; };               // reference to FULL_REFRESH_AFTER (default 5)
@@ -53,6 +109,30 @@ public:
   
   // Main display functions
   void refresh();
+  void refresh(const EinkCanvas& canvas);
+  // Double-buffered pages: draw into beginFrame() (nullptr if out of memory), then present() sends
+  // it on the refresh task while the next frame is drawn. done runs on that task when finished.
+  EinkCanvas* beginFrame();
+  void present(RefreshDone done = nullptr);
+  bool refreshBusy();
+  void waitForRefresh();
+  void startRefreshTask_();
+
+  // Wake the e-ink task; bursts of requests are coalesced into one applicationEinkHandler() pass
+  void requestRedraw(RedrawPriority priority = REDRAW_NORMAL);
+  // Called by the e-ink task between passes, sleeps until a redraw is requested
+  void waitForRedraw();
+
+  // Queue a recorded display list for the e-ink task; safe from any core
+  void submit(EinkDisplayList&& list);
+  // Called by the e-ink task before each pass: replay and commit everything submitted
+  void replayDisplayLists();
+  // Block until everything submitted so far is on the display
+  void waitForDisplayLists();
+  // Stop running applicationEinkHandler() after display lists, so a screen submitted last
+  // (e.g. the sleep screen) stays up; there is no resume, the device sleeps after
+  void holdAppPasses()                 { appPassesHeld_ = true; }
+  bool appPassesHeld() const           { return appPassesHeld_; }
   void multiPassRefresh(int passes);
   void setFastFullRefresh(bool setting);
   void statusBar(const String& input, bool fullWindow=false);
@@ -74,12 +154,46 @@ public:
   void forceSlowFullUpdate(bool force);
   
 private:
+  void selectRefreshMode_();
+  void sendCanvas_(const EinkCanvas& canvas);
+  static void refreshTask_(void* parameter);
+
+  // ghosting, per tile in panel coordinates
+  void     addGhost_(const EinkRect& area, uint16_t points, const uint16_t* flips = nullptr);
+  EinkRect ghostOverBudget_() const;  // Tile-aligned box around tiles due a clean-up, empty if none
+  void     resetGhost_(const EinkRect& area);
+  EinkRect toTiles_(const EinkRect& area) const;
+
   DisplayT&             display_; // class reference to hardware display object
   bool                  forceSlowFullUpdate_  = false;
-  uint8_t               partialCounter_       = 0;
   const GFXfont*        currentFont_          = nullptr;
   uint8_t               fullRefreshAfter_     = FULL_REFRESH_AFTER;
 
+  EinkRect              onScreen_;                      // Non-white area on the panel after the last refresh
+  uint32_t              onScreenWrites_       = 0;        // display_.panelWrites() when onScreen_ was set
+  uint16_t              ghost_[GHOST_TILES]   = {};     // Ghost score of each tile since it was last cleaned
+
+  // background refresh
+  EinkCanvas*           committed_            = nullptr;  // Copy of the last canvas sent
+  uint32_t              committedWrites_      = 0;        // display_.panelWrites() when it was sent
+  EinkCanvas*           front_                = nullptr;  // On its way to the panel
+  EinkCanvas*           back_                 = nullptr;  // Being drawn by the app
+  RefreshDone           done_;
+  SemaphoreHandle_t     idle_                 = nullptr;  // Held while a refresh is in flight
+
+  // display lists
+  std::vector<EinkDisplayList> lists_;
+  SemaphoreHandle_t     listLock_             = nullptr;  // Guards lists_ and both counts
+  SemaphoreHandle_t     listsDone_            = nullptr;  // Given after each batch is replayed
+  uint32_t              listsSubmitted_       = 0;
+  uint32_t              listsReplayed_        = 0;
+
+  // redraw requests
+  volatile bool         redrawPending_        = false;
+  volatile bool         redrawNow_            = false;
+  volatile ulong        idleRedrawAt_         = 0;      // millis() of a pending idle pass, 0 if none
+  volatile bool         appPassesHeld_        = false;
+
   // font metrics
   uint8_t               lineSpacing_          = 6;
   uint8_t               maxCharsPerLine_      = 0;
@@ -89,4 +203,20 @@ private:
 
 void setupEink();
 
-PocketmageEink& EINK();
\ No newline at end of file
+PocketmageEink& EINK();
+
+// App flag read by an e-ink handler; setting it also wakes the e-ink task
+class RedrawFlag {
+public:
+  explicit RedrawFlag(bool value = false) : value_(value) {}
+
+  RedrawFlag& operator=(bool value) {
+    value_ = value;
+    if (value) EINK().requestRedraw();
+    return *this;
+  }
+  operator bool() const { return value_; }
+
+private:
+  volatile bool value_ = false;
+};
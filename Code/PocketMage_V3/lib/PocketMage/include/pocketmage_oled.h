@@ -9,6 +9,7 @@
 #pragma once
 #include <Arduino.h>
 #include <U8g2lib.h>
+#include <Adafruit_GFX.h>
 #include <vector>
 #pragma region fonts
 #pragma endregion
@@ -16,7 +17,33 @@
 // OLED 
 extern U8G2_SSD1326_ER_256X32_F_4W_HW_SPI u8g2;
 
+// ===================== OLED FONT METRICS =====================
+// Advance widths of a u8g2 font, read from u8g2 once, so measuring a string is a table walk
+// rather than u8g2 decoding every glyph again. Covers printable ASCII, all the _tr fonts hold.
+class OledFontMetrics {
+public:
+  // Metrics for font, built on first use; building leaves font selected in u8
+  static const OledFontMetrics& of(U8G2& u8, const uint8_t* font);
+
+  // Same result as u8g2's getStrWidth()
+  uint16_t width(const char* s) const;
+  // Pen advance of c, and the width it adds instead when it ends a string
+  int8_t   advance(char c) const { return inRange(c) ? advance_[c - ' '] : 0; }
+  int8_t   tail(char c) const    { return inRange(c) ? tail_[c - ' '] : 0; }
+
+private:
+  static bool inRange(char c) { return c >= ' ' && c <= '~'; }
+
+  const uint8_t* font_;
+  int8_t         advance_['~' - ' ' + 1];
+  int8_t         tail_['~' - ' ' + 1];
+};
+
 // ===================== OLED CLASS =====================
+// Frames are still drawn into u8g2's buffer by whoever draws them, which costs no bus time.
+// sendBuffer() and toast() only hand a copy to the OLED compositor task, the one task that talks
+// to the panel: it shows the topmost live layer at most OLED_MAX_FPS times a second, pushing only
+// the tiles that changed. Frames committed faster than that are coalesced, the latest one wins.
 class PocketmageOled {
 public:
   explicit PocketmageOled(U8G2 &u8) : u8g2_(u8) {}
@@ -29,14 +56,66 @@ public:
   void infoBar();
   void setPowerSave(bool enable);
   bool getPowerSave() const                                   { return OLEDPowerSave_; }
+  void setContrast(uint8_t contrast);
+
+  // Compositor
+  // Commits u8g2's buffer as the app frame (editor line, info bar, idle animation, ...).
+  // Use instead of u8g2.sendBuffer(); never waits for the bus.
+  void sendBuffer();
+  // Counts app frames committed, so a caller keeping its drawing in u8g2's buffer between
+  // frames can tell when someone else has drawn over it
+  uint32_t appCommits() const                                 { return appCommits_; }
+  // Shows msg over the app frame for ms (OLED_TOAST_MS if 0), leaving u8g2's buffer as it was
+  void toast(const String& msg, uint16_t ms = 0);
+  // Next push sends every tile, e.g. if something wrote to the panel behind our back
+  void invalidate();
+  void startCompositorTask_();
 
 private:
+  enum Layer : uint8_t { LAYER_APP, LAYER_TOAST, LAYER_COUNT };   // Bottom to top
+
+  // Font oledWord() settled on for a message, kept for the next call with the same message
+  struct WordFit {
+    uint32_t hash;
+    uint16_t length;
+    uint16_t width;
+    uint8_t  font;     // Into the oledWord() font list
+    bool     fits;     // Otherwise drawn right-aligned in the smallest font
+  };
+  static constexpr uint8_t WORD_FITS = 4;
+
+  // oledLine()'s line, with widths kept up to date as characters are added or removed
+  struct LineMetrics {
+    String         text;
+    const GFXfont* einkFont    = nullptr;
+    uint32_t       einkAdvance = 0;   // Sum of e-ink glyph advances
+    uint32_t       oledAdvance = 0;   // Sum of OLED glyph advances in the line font
+  };
+
   U8G2                  &u8g2_;        // class reference to hardware oled object
   volatile bool OLEDPowerSave_;
+  volatile uint32_t     appCommits_ = 0;
+  std::vector<uint8_t>  layers_[LAYER_COUNT];   // Last frame committed to each layer
+  std::vector<uint8_t>  front_;                 // Frame being pushed, compositor task only
+  std::vector<uint8_t>  shadow_;                // What the panel shows
+  bool                  fullPush_   = true;
+  ulong                 toastUntil_ = 0;        // 0 while no toast is up
+  SemaphoreHandle_t     lock_       = nullptr;  // Layers, toastUntil_ and fullPush_
+  SemaphoreHandle_t     bus_        = nullptr;  // Everything that goes through u8x8
+  WordFit               fits_[WORD_FITS] = {};
+  uint8_t               nextFit_    = 0;
+  LineMetrics           line_;
  
   // helpers
   uint16_t strWidth(const String& s) const;
+  void     drawWord_(const String& word, bool allowLarge, bool showInfo);
+  WordFit  fitWord_(const String& word, bool allowLarge);
+  void     trackLine_(const String& line);
+  uint16_t lineWidthOled_();
+  void     commit_(Layer layer);
+  void     pushFrame_();
+  static void compositorTask_(void* parameter);
 };
 
 void setupOled();
-PocketmageOled& OLED();
\ No newline at end of file
+PocketmageOled& OLED();
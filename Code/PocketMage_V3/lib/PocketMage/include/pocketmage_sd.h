@@ -9,18 +9,53 @@
 #pragma once
 #include <Arduino.h>
 #include <FS.h>
+#include <functional>
 
 // forward-declaration to avoid including U8g2lib.h, GxEPD2_BW.h, pocketmage_oled.h, and pocketmage_eink.h
 class PocketmageOled;
 class PocketmageEink;
 
+// ===================== DOC STATS =====================
+// Text statistics stored with each file's metadata
+struct DocStats {
+  uint32_t chars      = 0;  // Printable ASCII, spaces included
+  uint32_t words      = 0;
+  uint32_t lines      = 0;
+  uint32_t paragraphs = 0;  // Runs of non-blank lines
+};
+
+// Counts DocStats over text fed in arbitrary chunks, so files never have to be held in RAM
+class DocStatsCounter {
+public:
+  void feed(const char* data, size_t len);
+  void feed(const String& text)       { feed(text.c_str(), text.length()); }
+  void feedLine(const String& line)   { feed(line); feed("\n", 1); }
+  DocStats finish();
+
+private:
+  void endLine_();
+
+  DocStats              stats_;
+  bool                  inWord_         = false;
+  bool                  lineOpen_       = false;
+  bool                  lineHasText_    = false;
+  bool                  inParagraph_    = false;
+};
+
 // ===================== SD CLASS =====================
 class PocketmageSD {
 public:
   explicit PocketmageSD() {}
 
+  using FilesChangingFn = std::function<void(const String& path)>;
+
+  // Called with each path delFile(), renFile() and copyFile() are about to change, before they
+  // touch the card, so apps can save and let go of copies and caches of those files
+  void setFilesChangingCallback(FilesChangingFn fn)   { filesChanging_ = std::move(fn); }
+
   void saveFile();
   void writeMetadata(const String& path);
+  void writeMetadata(const String& path, const DocStats& stats);
   void loadFile(bool showOLED = true);
   void delFile(String fileName);
   void deleteMetadata(String path);
@@ -66,6 +101,8 @@ private:
   uint8_t                       fileIndex_        = 0;
   String                        excludedFiles_[3] = { "/temp.txt", "/settings.txt", "/tasks.txt" };
 
+  FilesChangingFn               filesChanging_;
+
   // Flags / counters
   bool                          noSD_              = false;
 };
@@ -10,6 +10,7 @@
 #pragma once
 #include <Arduino.h>
 #include <vector>
+#include <pocketmage_eink.h> // RedrawFlag
 
 class String;
 
@@ -23,6 +24,7 @@ extern bool rebootToPocketMage();
 
 namespace pocketmage{
   void setCpuSpeed(int newFreq);
+  // alternateScreenSaver: the caller has already put its own sleep screen on the panel
   void deepSleep(bool alternateScreenSaver = false);
   bool setRebootFlagOTA();
   void checkRebootOTA();
@@ -36,6 +38,6 @@ String vectorToString();
 void stringToVector(String inputText);
 String removeChar(String str, char character);
 int stringToInt(String str);
-extern volatile bool newLineAdded;           // New line added in TXT
+extern RedrawFlag newLineAdded;              // New line added in TXT
 extern std::vector<String> allLines;                // All lines in TXT
 extern bool noTimeout;               // Disable timeout
\ No newline at end of file
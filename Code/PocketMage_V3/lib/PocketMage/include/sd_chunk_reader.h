@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+// Reads the card a sector at a time while handing out single bytes
+class ChunkReader {
+public:
+  explicit ChunkReader(File& file) : file_(file) {}
+
+  int read() {
+    if (pos_ == len_) {
+      len_ = file_.read(buf_, sizeof(buf_));
+      pos_ = 0;
+      if (len_ == 0) return -1;
+    }
+    return buf_[pos_++];
+  }
+  size_t read(uint8_t* dst, size_t n) {
+    size_t got = 0;
+    while (got < n) {
+      const int c = read();
+      if (c < 0) break;
+      dst[got++] = (uint8_t)c;
+    }
+    return got;
+  }
+  // Drops n bytes; false if the file ends first
+  bool skip(uint32_t n) {
+    const size_t buffered = len_ - pos_;
+    if (n <= buffered) {
+      pos_ += n;
+      return true;
+    }
+    n -= buffered;
+    pos_ = len_ = 0;
+    return file_.seek(file_.position() + n) && file_.position() <= file_.size();
+  }
+
+private:
+  File&   file_;
+  uint8_t buf_[512];
+  size_t  pos_ = 0;
+  size_t  len_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+
+// ===================== SPI BUS =====================
+// The OLED and the e-ink panel share SPI_MOSI/SPI_SCK and are driven from different tasks.
+// Every transfer to either happens under a lease; while a device is waiting, devices below it
+// hand the bus over at their next release instead of taking it straight back, so the e-ink
+// panel, which writes its image in EINK_SPI_BAND_ROWS bands, lets OLED frames through between
+// bands. The SD card is on its own SDMMC pins and does not take part.
+
+// Lower value, higher priority
+enum SpiDevice : uint8_t {
+  SPI_DEVICE_OLED,
+  SPI_DEVICE_EINK,
+  SPI_DEVICE_COUNT
+};
+
+class SpiBus {
+public:
+  struct Stats {
+    uint32_t leases;
+    uint64_t busyUs;      // Time holding the bus
+    uint64_t waitUs;      // Time queued for it
+    uint32_t maxWaitUs;
+  };
+
+  void  acquire(SpiDevice device);
+  void  release(SpiDevice device);
+  // Counters since the last resetStats()
+  Stats stats(SpiDevice device) const;
+  void  resetStats();
+  // Logs each device's share of the bus and queue wait since the last call, then resets
+  void  logStats();
+
+private:
+  bool higherWaiting_(SpiDevice device) const;
+
+  SemaphoreHandle_t lock_                       = nullptr;
+  portMUX_TYPE      mux_                        = portMUX_INITIALIZER_UNLOCKED;
+  volatile uint8_t  waiting_[SPI_DEVICE_COUNT]  = {};
+  uint32_t          since_                      = 0;   // micros() when the owner took the bus
+  Stats             stats_[SPI_DEVICE_COUNT]    = {};
+  uint32_t          statsFrom_                  = 0;   // micros() at the last reset
+};
+
+SpiBus& SPIBUS();
+
+// Holds the bus for device for the rest of the scope
+class SpiLease {
+public:
+  explicit SpiLease(SpiDevice device) : device_(device) { SPIBUS().acquire(device_); }
+  ~SpiLease() { SPIBUS().release(device_); }
+  SpiLease(const SpiLease&)            = delete;
+  SpiLease& operator=(const SpiLease&) = delete;
+
+private:
+  SpiDevice device_;
+};
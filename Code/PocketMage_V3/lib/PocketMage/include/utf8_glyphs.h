@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+
+// ===================== UTF-8 GLYPHS =====================
+// Text stays UTF-8 in memory and on the card; it only becomes glyph bytes for the 8b GFX fonts
+// on its way to the display. Every 8b font shares one extended range (0x80-0xDF: Latin-1 shifted
+// down by 0x20, with € Š š Ž ž Œ œ Ÿ in place of ¤ ¦ ¨ ´ ¸ ¼ ½ ¾), so one table serves every face.
+// Codepoints without a glyph draw as GLYPH_FALLBACK, the replacement box at 0x7F. Bytes that are
+// not valid UTF-8 are read as Latin-1, which is what older notes on the card usually are.
+
+static constexpr uint8_t GLYPH_FALLBACK = 0x7F;
+
+// 8b font glyph for a codepoint, GLYPH_FALLBACK if the fonts have none. Two table lookups at most.
+uint8_t  glyphFor(uint32_t cp);
+// Decodes the codepoint at s and moves s past it; s must not point at the terminator
+uint32_t utf8Next(const char*& s);
+// Length in bytes of the last character of s (0 for an empty string), for backspace
+size_t   utf8LastLength(const String& s);
+
+// A UTF-8 string as 8b font glyph bytes, for getTextBounds() and print(). Plain ASCII, nearly
+// every word, is used in place without copying; anything else is decoded once into a buffer.
+class GlyphText {
+public:
+  explicit GlyphText(const char* utf8);
+  explicit GlyphText(const String& utf8) : GlyphText(utf8.c_str()) {}
+  GlyphText(const GlyphText&)            = delete;
+  GlyphText& operator=(const GlyphText&) = delete;
+
+  const char* c_str() const { return text_; }
+
+private:
+  char                    short_[48];
+  std::unique_ptr<char[]> long_;   // Words too long for short_
+  const char*             text_;
+};
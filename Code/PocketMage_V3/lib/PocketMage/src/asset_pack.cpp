@@ -0,0 +1,113 @@
+#include <pocketmage.h>
+
+static constexpr const char* tag = "ASSETS";
+
+static AssetCache pm_assets;
+
+AssetCache& ASSETS() { return pm_assets; }
+
+static size_t bitmapBytes(const AssetEntry& entry) {
+  return (size_t)((entry.width + 7) / 8) * entry.height;
+}
+
+// ===================== ASSET CACHE =====================
+const uint8_t* AssetCache::get(uint16_t id) {
+  if (id >= ASSET_COUNT) return nullptr;
+
+  AssetEntry entry;
+  memcpy_P(&entry, &ASSET_INDEX[id], sizeof(entry));
+  if (entry.size == 0) return nullptr;
+  if (entry.format == ASSET_RAW) return ASSET_DATA + entry.offset;
+
+  for (auto& c : cached_) {
+    if (c.id == id) {
+      c.lastUse = ++useTick_;
+      return c.data;
+    }
+  }
+
+  const size_t size = bitmapBytes(entry);
+  evict_(size);
+  uint8_t* data = (uint8_t*)(psramFound() ? ps_malloc(size) : malloc(size));
+  if (!data) {
+    ESP_LOGE(tag, "No memory for asset %u (%u bytes)", id, (unsigned)size);
+    return nullptr;
+  }
+  if (!unpack_(entry, data, size)) {
+    ESP_LOGE(tag, "Asset %u is corrupt", id);
+    free(data);
+    return nullptr;
+  }
+
+  cached_.push_back({id, ++useTick_, data, size});
+  bytes_ += size;
+  return data;
+}
+
+bool AssetCache::draw(uint16_t id, int16_t x, int16_t y, Adafruit_GFX& gfx, uint16_t color) {
+  const uint8_t* bitmap = get(id);
+  if (!bitmap) return false;
+  gfx.drawBitmap(x, y, bitmap, width(id), height(id), color);
+  return true;
+}
+
+uint16_t AssetCache::width(uint16_t id) const {
+  return id < ASSET_COUNT ? pgm_read_word(&ASSET_INDEX[id].width) : 0;
+}
+
+uint16_t AssetCache::height(uint16_t id) const {
+  return id < ASSET_COUNT ? pgm_read_word(&ASSET_INDEX[id].height) : 0;
+}
+
+void AssetCache::clear() {
+  for (auto& c : cached_) free(c.data);
+  cached_.clear();
+  bytes_ = 0;
+}
+
+// PackBits: header n < 128 copies n + 1 literal bytes, n > 128 repeats the next byte
+// 257 - n times, 128 is a no-op
+bool AssetCache::unpack_(const AssetEntry& entry, uint8_t* dst, size_t size) const {
+  const uint8_t* src = ASSET_DATA + entry.offset;
+  const uint8_t* end = src + entry.size;
+  size_t         out = 0;
+  while (out < size && src < end) {
+    const uint8_t header = pgm_read_byte(src++);
+    if (header == 128) continue;
+    if (header < 128) {
+      const size_t n = header + 1;
+      if (out + n > size || src + n > end) return false;
+      memcpy_P(dst + out, src, n);
+      src += n;
+      out += n;
+    } else {
+      const size_t n = 257 - header;
+      if (out + n > size || src >= end) return false;
+      memset(dst + out, pgm_read_byte(src++), n);
+      out += n;
+    }
+  }
+  if (out != size) return false;
+
+  if (entry.format == ASSET_PACKBITS_DELTA) {
+    const size_t rowBytes = (entry.width + 7) / 8;
+    for (size_t i = rowBytes; i < size; i++) dst[i] ^= dst[i - rowBytes];
+  }
+  return true;
+}
+
+// Drop the least recently used images until `need` more bytes fit the budget
+void AssetCache::evict_(size_t need) {
+  const size_t budget = (size_t)ASSET_CACHE_KB * 1024;
+  while (!cached_.empty() && bytes_ + need > budget) {
+    auto oldest = cached_.begin();
+    for (auto it = cached_.begin(); it != cached_.end(); ++it) {
+      if (it->lastUse < oldest->lastUse) oldest = it;
+    }
+
+    ESP_LOGD(tag, "Evicting asset %u", oldest->id);
+    bytes_ -= oldest->size;
+    free(oldest->data);
+    cached_.erase(oldest);
+  }
+}
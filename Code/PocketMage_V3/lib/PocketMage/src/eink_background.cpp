@@ -0,0 +1,140 @@
+#include <pocketmage.h>
+#include <SD_MMC.h>
+#include <sd_chunk_reader.h>
+
+static constexpr const char* tag = "BACKGROUND";
+
+static constexpr uint16_t BG_MAX_WIDTH  = 320;
+static constexpr uint16_t BG_MAX_HEIGHT = 240;
+static constexpr uint8_t  STRIP_ROWS    = 8;   // Rows decoded and drawn per step
+
+// ===================== index =====================
+static bool isBackgroundName(const String& name) {
+  return name.endsWith(".bin") || name.endsWith(".pmb") || isImageFile(name);
+}
+
+static bool writeIndex() {
+  File dir = SD_MMC.open(BACKGROUNDS_DIR);
+  if (!dir) return false;
+
+  std::vector<String> names;
+  File file;
+  while ((file = dir.openNextFile())) {
+    String name = file.name();
+    if (!file.isDirectory() && isBackgroundName(name)) names.push_back(name);
+    file.close();
+  }
+  dir.close();
+
+  File index = SD_MMC.open(BACKGROUND_INDEX_FILE, FILE_WRITE);
+  if (!index) return false;
+  index.println(names.size());
+  for (const String& name : names) index.println(name);
+  index.close();
+  ESP_LOGI(tag, "Indexed %u backgrounds", (unsigned)names.size());
+  return true;
+}
+
+String pickBackground() {
+  if (!SD_MMC.exists(BACKGROUND_INDEX_FILE) && !writeIndex()) return "";
+
+  File index = SD_MMC.open(BACKGROUND_INDEX_FILE);
+  if (!index) return "";
+
+  String name;
+  const long count = index.readStringUntil('\n').toInt();
+  if (count > 0) {
+    const long pick = esp_random() % count;
+    for (long i = 0; i <= pick && index.available(); i++) name = index.readStringUntil('\n');
+    name.trim();
+  }
+  index.close();
+  return name;
+}
+
+void invalidateBackgroundIndex() {
+  if (SD_MMC.exists(BACKGROUND_INDEX_FILE)) SD_MMC.remove(BACKGROUND_INDEX_FILE);
+}
+
+// ===================== streaming decode =====================
+// PackBits: header n < 128 copies n + 1 literal bytes, n > 128 repeats the next byte
+// 257 - n times, 128 is a no-op. Runs may cross strip boundaries.
+class PackBitsDecoder {
+public:
+  explicit PackBitsDecoder(ChunkReader& in) : in_(in) {}
+
+  bool decode(uint8_t* dst, size_t n) {
+    for (size_t i = 0; i < n;) {
+      if (run_ == 0) {
+        const int header = in_.read();
+        if (header < 0) return false;
+        if (header == 128) continue;
+        repeat_ = header > 128;
+        run_    = repeat_ ? 257 - header : header + 1;
+        if (repeat_) {
+          const int value = in_.read();
+          if (value < 0) return false;
+          value_ = (uint8_t)value;
+        }
+      }
+
+      if (repeat_) {
+        dst[i++] = value_;
+      } else {
+        const int value = in_.read();
+        if (value < 0) return false;
+        dst[i++] = (uint8_t)value;
+      }
+      run_--;
+    }
+    return true;
+  }
+
+private:
+  ChunkReader& in_;
+  uint16_t     run_    = 0;
+  bool         repeat_ = false;
+  uint8_t      value_  = 0;
+};
+
+bool drawBackgroundFile(const String& path, Adafruit_GFX& gfx) {
+  if (isImageFile(path)) return drawImageFile(path, gfx);
+
+  File file = SD_MMC.open(path);
+  if (!file) return false;
+
+  ChunkReader in(file);
+  const bool  packed = path.endsWith(".pmb");
+  uint16_t    width  = BG_MAX_WIDTH;
+  uint16_t    height = BG_MAX_HEIGHT;
+  if (packed) {
+    uint8_t header[8];
+    if (in.read(header, sizeof(header)) != sizeof(header) || memcmp(header, "PMB1", 4) != 0) {
+      ESP_LOGE(tag, "Not a PMB1 file: %s", path.c_str());
+      file.close();
+      return false;
+    }
+    width  = header[4] | (header[5] << 8);
+    height = header[6] | (header[7] << 8);
+    if (width == 0 || height == 0 || width > BG_MAX_WIDTH || height > BG_MAX_HEIGHT) {
+      ESP_LOGE(tag, "Bad size %ux%u: %s", width, height, path.c_str());
+      file.close();
+      return false;
+    }
+  }
+
+  const size_t    rowBytes = (width + 7) / 8;
+  uint8_t         strip[(BG_MAX_WIDTH / 8) * STRIP_ROWS];
+  PackBitsDecoder unpack(in);
+  bool            ok = true;
+  for (uint16_t y = 0; y < height && ok; y += STRIP_ROWS) {
+    const uint16_t rows  = min<uint16_t>(STRIP_ROWS, height - y);
+    const size_t   bytes = rowBytes * rows;
+    ok = packed ? unpack.decode(strip, bytes) : in.read(strip, bytes) == bytes;
+    if (ok) gfx.drawBitmap(0, y, strip, width, rows, GxEPD_BLACK);
+  }
+  file.close();
+
+  if (!ok) ESP_LOGE(tag, "Truncated background: %s", path.c_str());
+  return ok;
+}
@@ -0,0 +1,405 @@
+#include <pocketmage.h>
+#include <eink_bits.h>
+
+static constexpr const char* tag = "EINK_CANVAS";
+
+static EinkGlyphCache pm_glyphs;
+
+EinkGlyphCache& GLYPHS() { return pm_glyphs; }
+
+// ===================== GLYPH CACHE =====================
+// Only used from the e-ink task, or by FONTS() unloading a font while nothing is drawing, so
+// no locking
+const CachedGlyph* EinkGlyphCache::get(const GFXfont* font, uint8_t c, const uint8_t** bitmap) {
+  const uint8_t first = pgm_read_byte(&font->first);
+  const uint8_t last  = pgm_read_byte(&font->last);
+  if (c < first || c > last) return nullptr;
+
+  FontGlyphs* fg = fontGlyphs_(font);
+  if (!fg) return nullptr;
+  fg->lastUse = ++useTick_;
+
+  CachedGlyph& g = fg->glyphs[c - first];
+  if (!g.cached) {
+    const GFXglyph* glyph = (const GFXglyph*)pgm_read_ptr(&font->glyph) + (c - first);
+    const uint8_t*  src   = (const uint8_t*)pgm_read_ptr(&font->bitmap);
+    const uint8_t   w     = pgm_read_byte(&glyph->width);
+    const uint8_t   h     = pgm_read_byte(&glyph->height);
+
+    g.rows     = w;
+    g.bits     = h;
+    g.rowBytes = (h + 7) / 8;
+    g.xOffset  = (int8_t)pgm_read_byte(&glyph->xOffset);
+    g.yOffset  = (int8_t)pgm_read_byte(&glyph->yOffset);
+    g.xAdvance = pgm_read_byte(&glyph->xAdvance);
+
+    const size_t size = (size_t)g.rows * g.rowBytes;
+    if (bytes_ + size > (size_t)EINK_GLYPH_CACHE_KB * 1024) evict_(fg);
+    g.offset = fg->data.size();
+    fg->data.resize(fg->data.size() + size, 0);
+    bytes_ += size;
+
+    // Unpack the glyph's bit stream; column xx becomes native row (w - 1 - xx)
+    uint8_t* out  = fg->data.data() + g.offset;
+    uint16_t bo   = pgm_read_word(&glyph->bitmapOffset);
+    uint8_t  bits = 0, bit = 0;
+    for (uint8_t yy = 0; yy < h; yy++) {
+      for (uint8_t xx = 0; xx < w; xx++) {
+        if (!(bit++ & 7)) bits = pgm_read_byte(&src[bo++]);
+        if (bits & 0x80) out[(w - 1 - xx) * g.rowBytes + (yy >> 3)] |= 0x80 >> (yy & 7);
+        bits <<= 1;
+      }
+    }
+    g.cached = true;
+  }
+
+  *bitmap = fg->data.data() + g.offset;
+  return &g;
+}
+
+void EinkGlyphCache::clear() {
+  fonts_.clear();
+  bytes_ = 0;
+}
+
+void EinkGlyphCache::forget(const GFXfont* font) {
+  for (auto it = fonts_.begin(); it != fonts_.end(); ++it) {
+    if (it->font != font) continue;
+    bytes_ -= it->data.size();
+    fonts_.erase(it);
+    return;
+  }
+}
+
+EinkGlyphCache::FontGlyphs* EinkGlyphCache::fontGlyphs_(const GFXfont* font) {
+  for (auto& fg : fonts_) {
+    if (fg.font == font) return &fg;
+  }
+
+  const uint8_t first = pgm_read_byte(&font->first);
+  const uint8_t last  = pgm_read_byte(&font->last);
+  FontGlyphs fg;
+  fg.font    = font;
+  fg.lastUse = 0;
+  fg.glyphs.assign(last - first + 1, CachedGlyph{0, 0, 0, 0, 0, 0, 0, false});
+  fonts_.push_back(std::move(fg));
+  return &fonts_.back();
+}
+
+// Drop the glyphs of the least recently used fonts until under budget
+void EinkGlyphCache::evict_(const FontGlyphs* keep) {
+  const size_t budget = (size_t)EINK_GLYPH_CACHE_KB * 1024;
+  while (bytes_ > budget / 2) {
+    FontGlyphs* oldest = nullptr;
+    for (auto& fg : fonts_) {
+      if (&fg == keep || fg.data.empty()) continue;
+      if (!oldest || fg.lastUse < oldest->lastUse) oldest = &fg;
+    }
+    if (!oldest) break;
+
+    ESP_LOGD(tag, "Evicting %u glyph bytes", (unsigned)oldest->data.size());
+    bytes_ -= oldest->data.size();
+    std::vector<uint8_t>().swap(oldest->data);
+    for (auto& g : oldest->glyphs) g.cached = false;
+  }
+}
+
+// ===================== EINK CANVAS =====================
+EinkCanvas::EinkCanvas() : Adafruit_GFX(NATIVE_WIDTH, NATIVE_HEIGHT) {
+  buffer_ = (uint8_t*)malloc(BUFFER_BYTES);
+  if (!buffer_) ESP_LOGE(tag, "No memory for canvas buffer");
+  setRotation(3);
+  setTextColor(GxEPD_BLACK);
+}
+
+EinkCanvas::~EinkCanvas() { free(buffer_); }
+
+void EinkCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer_ || x < 0 || x >= width() || y < 0 || y >= height()) return;
+
+  // Same mapping as GxEPD2_BW::drawPixel
+  switch (getRotation()) {
+    case 1:
+      std::swap(x, y);
+      x = NATIVE_WIDTH - x - 1;
+      break;
+    case 2:
+      x = NATIVE_WIDTH - x - 1;
+      y = NATIVE_HEIGHT - y - 1;
+      break;
+    case 3:
+      std::swap(x, y);
+      y = NATIVE_HEIGHT - y - 1;
+      break;
+  }
+
+  uint8_t* p = &buffer_[y * STRIDE + (x >> 3)];
+  if (color) *p |= (0x80 >> (x & 7));
+  else       *p &= ~(0x80 >> (x & 7));
+}
+
+void EinkCanvas::fillScreen(uint16_t color) {
+  if (buffer_) memset(buffer_, color ? 0xFF : 0x00, BUFFER_BYTES);
+}
+
+void EinkCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w < 0) { x += w; w = -w; }
+  if (h < 0) { y += h; h = -h; }
+  // Clip in logical coordinates
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width())  w = width() - x;
+  if (y + h > height()) h = height() - y;
+  if (w <= 0 || h <= 0) return;
+
+  // Same mapping as drawPixel, applied to the whole rect
+  switch (getRotation()) {
+    case 0:
+      fillNative_(x, y, w, h, color);
+      break;
+    case 1:
+      fillNative_(NATIVE_WIDTH - (y + h), x, h, w, color);
+      break;
+    case 2:
+      fillNative_(NATIVE_WIDTH - (x + w), NATIVE_HEIGHT - (y + h), w, h, color);
+      break;
+    case 3:
+      fillNative_(y, NATIVE_HEIGHT - (x + w), h, w, color);
+      break;
+  }
+}
+
+void EinkCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)  { fillRect(x, y, w, 1, color); }
+void EinkCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)  { fillRect(x, y, 1, h, color); }
+void EinkCanvas::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+void EinkCanvas::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillRect(x, y, w, 1, color); }
+void EinkCanvas::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { fillRect(x, y, 1, h, color); }
+
+// Rect already clipped and in panel coordinates
+void EinkCanvas::fillNative_(int16_t nx, int16_t ny, int16_t nw, int16_t nh, bool white) {
+  if (!buffer_) return;
+
+  const int16_t firstByte = nx >> 3;
+  const int16_t lastByte  = (nx + nw - 1) >> 3;
+  uint8_t firstMask = 0xFF >> (nx & 7);
+  uint8_t lastMask  = 0xFF << (7 - ((nx + nw - 1) & 7));
+  if (firstByte == lastByte) firstMask &= lastMask;
+
+  for (int16_t row = ny; row < ny + nh; row++) {
+    uint8_t* p = buffer_ + row * STRIDE + firstByte;
+    if (white) *p |= firstMask;
+    else       *p &= ~firstMask;
+    if (firstByte == lastByte) continue;
+
+    const int16_t middle = lastByte - firstByte - 1;
+    if (middle > 0) memset(p + 1, white ? 0xFF : 0x00, middle);
+    p += lastByte - firstByte;
+    if (white) *p |= lastMask;
+    else       *p &= ~lastMask;
+  }
+}
+
+// Write 8 bits starting at native (nx, ny); only bits in mask are touched
+void EinkCanvas::writeBits_(int16_t nx, int16_t ny, uint8_t bits, uint8_t mask, uint16_t color,
+                            uint16_t bg, bool opaque) {
+  uint8_t*      p     = buffer_ + ny * STRIDE + (nx >> 3);
+  const uint8_t shift = nx & 7;
+  const uint8_t fg    = bits & mask;
+  const uint8_t back  = opaque ? (~bits & mask) : 0;
+
+  for (uint8_t half = 0; half < (shift ? 2 : 1); half++, p++) {
+    const uint8_t f = half ? fg << (8 - shift) : fg >> shift;
+    const uint8_t b = half ? back << (8 - shift) : back >> shift;
+    if (!(f | b)) continue;
+    if (color) *p |= f;
+    else       *p &= ~f;
+    if (bg) *p |= b;
+    else    *p &= ~b;
+  }
+}
+
+void EinkCanvas::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                            uint16_t color) {
+  blitBitmap_(x, y, bitmap, w, h, color, 0, false);
+}
+
+void EinkCanvas::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                            uint16_t color, uint16_t bg) {
+  blitBitmap_(x, y, bitmap, w, h, color, bg, true);
+}
+
+void EinkCanvas::blitBitmap_(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                             uint16_t color, uint16_t bg, bool opaque) {
+  // Anything partly off-screen or in another rotation takes the generic path
+  if (!buffer_ || getRotation() != 3 || x < 0 || y < 0 || x + w > width() || y + h > height()) {
+    if (opaque) Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color, bg);
+    else        Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color);
+    return;
+  }
+
+  // Logical column x + i becomes native row NATIVE_HEIGHT - 1 - (x + i); logical rows become
+  // bits along that native row starting at nx = y.
+  const int16_t byteWidth = (w + 7) / 8;
+  uint8_t block[8], columns[8];
+  for (int16_t r0 = 0; r0 < h; r0 += 8) {
+    const uint8_t rowsInBlock = min<int16_t>(8, h - r0);
+    const uint8_t mask        = 0xFF << (8 - rowsInBlock);
+
+    for (int16_t c = 0; c < byteWidth; c++) {
+      for (uint8_t r = 0; r < 8; r++)
+        block[r] = (r < rowsInBlock) ? pgm_read_byte(&bitmap[(r0 + r) * byteWidth + c]) : 0;
+      transpose8(block, columns);
+
+      for (uint8_t k = 0; k < 8 && c * 8 + k < w; k++) {
+        if (!opaque && !columns[k]) continue;
+        writeBits_(y + r0, NATIVE_HEIGHT - 1 - (x + c * 8 + k), columns[k], mask, color, bg,
+                   opaque);
+      }
+    }
+  }
+}
+
+void EinkCanvas::drawNativeBitmap(int16_t nx, int16_t ny, const uint8_t bitmap[], int16_t nw,
+                                  int16_t nh, uint16_t color) {
+  blitNative_(nx, ny, bitmap, nw, nh, color, 0, false);
+}
+
+void EinkCanvas::drawNativeBitmap(int16_t nx, int16_t ny, const uint8_t bitmap[], int16_t nw,
+                                  int16_t nh, uint16_t color, uint16_t bg) {
+  blitNative_(nx, ny, bitmap, nw, nh, color, bg, true);
+}
+
+void EinkCanvas::blitNative_(int16_t nx, int16_t ny, const uint8_t bitmap[], int16_t nw,
+                             int16_t nh, uint16_t color, uint16_t bg, bool opaque) {
+  if (!buffer_) return;
+  const int16_t byteWidth = (nw + 7) / 8;
+
+  for (int16_t row = 0; row < nh; row++) {
+    if (ny + row < 0 || ny + row >= NATIVE_HEIGHT) continue;
+    const uint8_t* src = bitmap + row * byteWidth;
+    for (int16_t b = 0; b < byteWidth; b++) {
+      const int16_t bx = nx + b * 8;
+      const uint8_t bitsInByte = min<int16_t>(8, nw - b * 8);
+      uint8_t mask = 0xFF << (8 - bitsInByte);
+      // Clip bits that fall off the left or right of the panel
+      if (bx < 0) mask &= (bx > -8) ? (0xFF >> -bx) : 0;
+      if (bx + 8 > NATIVE_WIDTH) mask &= (bx < NATIVE_WIDTH) ? (0xFF << (bx + 8 - NATIVE_WIDTH)) : 0;
+      if (!mask) continue;
+
+      if (bx < 0) {
+        // Shift the visible bits down to the first byte of the row
+        const uint8_t s = -bx;
+        writeBits_(0, ny + row, pgm_read_byte(&src[b]) << s, mask << s, color, bg, opaque);
+      } else {
+        writeBits_(bx, ny + row, pgm_read_byte(&src[b]), mask, color, bg, opaque);
+      }
+    }
+  }
+}
+
+void EinkCanvas::rotateToNative(const uint8_t src[], int16_t w, int16_t h, uint8_t* dst) {
+  const int16_t srcBytes = (w + 7) / 8;
+  const int16_t dstBytes = (h + 7) / 8;
+  memset(dst, 0, (size_t)dstBytes * w);
+
+  uint8_t block[8], columns[8];
+  for (int16_t r0 = 0; r0 < h; r0 += 8) {
+    for (int16_t c = 0; c < srcBytes; c++) {
+      for (uint8_t r = 0; r < 8; r++)
+        block[r] = (r0 + r < h) ? pgm_read_byte(&src[(r0 + r) * srcBytes + c]) : 0;
+      transpose8(block, columns);
+      // Logical column i lands on native row w - 1 - i
+      for (uint8_t k = 0; k < 8 && c * 8 + k < w; k++)
+        dst[(w - 1 - (c * 8 + k)) * dstBytes + (r0 >> 3)] = columns[k];
+    }
+  }
+}
+
+void EinkCanvas::copyFrom(const EinkCanvas& other) {
+  if (buffer_ && other.buffer_) memcpy(buffer_, other.buffer_, BUFFER_BYTES);
+}
+
+static_assert(EINK_GHOST_TILE % 8 == 0, "ghost tiles must cover whole buffer bytes");
+
+EinkRect EinkCanvas::diff(const EinkCanvas& other, uint16_t* tileFlips) const {
+  if (!buffer_ || !other.buffer_) return {0, 0, NATIVE_WIDTH, NATIVE_HEIGHT};
+
+  // Buffers come from malloc, so they are word aligned
+  const BitsDiff d = diffBits(buffer_, other.buffer_, BUFFER_BYTES, STRIDE, EINK_GHOST_TILE,
+                              PocketmageEink::GHOST_COLS, tileFlips);
+  if (d.empty()) return EinkRect();
+  return {(int16_t)(d.colMin * 8), d.rowMin, (int16_t)((d.colMax - d.colMin + 1) * 8),
+          (int16_t)(d.rowMax - d.rowMin + 1)};
+}
+
+// Adafruit_GFX::write with the glyph drawn from the cache
+size_t EinkCanvas::write(uint8_t c) {
+  if (!gfxFont || !buffer_ || textsize_x != 1 || textsize_y != 1 || getRotation() != 3)
+    return Adafruit_GFX::write(c);
+
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+    return 1;
+  }
+  if (c == '\r') return 1;
+
+  const uint8_t*     bitmap = nullptr;
+  const CachedGlyph* g      = GLYPHS().get(gfxFont, c, &bitmap);
+  if (!g) {
+    const uint8_t first = pgm_read_byte(&gfxFont->first);
+    const uint8_t last  = pgm_read_byte(&gfxFont->last);
+    return (c >= first && c <= last) ? Adafruit_GFX::write(c) : 1;
+  }
+
+  if (g->rows && g->bits) {
+    if (wrap && (cursor_x + g->xOffset + g->rows) > _width) {
+      cursor_x = 0;
+      cursor_y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+    }
+    blitGlyph_(*g, bitmap, cursor_x, cursor_y);
+  }
+  cursor_x += g->xAdvance;
+  return 1;
+}
+
+void EinkCanvas::blitGlyph_(const CachedGlyph& g, const uint8_t* bitmap, int16_t x, int16_t y) {
+  // Logical (x, y) is the baseline origin; rotation 3 maps it to native (y, HEIGHT - 1 - x)
+  const int16_t nx0 = y + g.yOffset;
+  const int16_t ny0 = NATIVE_HEIGHT - (x + g.xOffset + g.rows);
+  const bool    black = (textcolor == 0);
+
+  // Glyphs cut by the top or bottom edge of the screen go pixel by pixel
+  if (nx0 < 0 || nx0 + g.bits > NATIVE_WIDTH) {
+    for (uint8_t k = 0; k < g.rows; k++) {
+      const uint8_t* src = bitmap + k * g.rowBytes;
+      for (uint8_t j = 0; j < g.bits; j++) {
+        if (src[j >> 3] & (0x80 >> (j & 7)))
+          drawPixel(x + g.xOffset + g.rows - 1 - k, y + g.yOffset + j, textcolor);
+      }
+    }
+    return;
+  }
+
+  const uint8_t shift = nx0 & 7;
+  for (uint8_t k = 0; k < g.rows; k++) {
+    const int16_t ny = ny0 + k;
+    if (ny < 0 || ny >= NATIVE_HEIGHT) continue;
+
+    const uint8_t* src = bitmap + k * g.rowBytes;
+    uint8_t*       dst = buffer_ + ny * STRIDE + (nx0 >> 3);
+    for (uint8_t b = 0; b < g.rowBytes; b++) {
+      if (!src[b]) continue;
+      const uint16_t m  = (uint16_t)src[b] << (8 - shift);
+      const uint8_t  hi = m >> 8;
+      const uint8_t  lo = m & 0xFF;
+      if (black) {
+        dst[b] &= ~hi;
+        if (lo) dst[b + 1] &= ~lo;
+      } else {
+        dst[b] |= hi;
+        if (lo) dst[b + 1] |= lo;
+      }
+    }
+  }
+}
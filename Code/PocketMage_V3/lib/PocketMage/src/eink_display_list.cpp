@@ -0,0 +1,59 @@
+#include <pocketmage.h>
+
+void EinkDisplayList::fillScreen(uint16_t color) {
+  ops_.push_back({OP_FILL_SCREEN, 0, 0, 0, 0, color, nullptr});
+}
+void EinkDisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  ops_.push_back({OP_FILL_RECT, x, y, w, h, color, nullptr});
+}
+void EinkDisplayList::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  ops_.push_back({OP_DRAW_RECT, x, y, w, h, color, nullptr});
+}
+void EinkDisplayList::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  ops_.push_back({OP_LINE, x0, y0, x1, y1, color, nullptr});
+}
+void EinkDisplayList::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w,
+                                 int16_t h, uint16_t color) {
+  ops_.push_back({OP_BITMAP, x, y, w, h, color, bitmap});
+}
+void EinkDisplayList::text(int16_t x, int16_t y, const GFXfont* font, const String& s,
+                           uint16_t color) {
+  ops_.push_back({OP_TEXT, x, y, 0, 0, color, font});
+  text_.push_back(s);
+}
+void EinkDisplayList::draw(Draw fn) {
+  ops_.push_back({OP_DRAW, 0, 0, 0, 0, 0, (const void*)(uintptr_t)draws_.size()});
+  draws_.push_back(std::move(fn));
+}
+
+void EinkDisplayList::replay(Adafruit_GFX& gfx) const {
+  size_t nextText = 0;
+  for (const Op& op : ops_) {
+    switch (op.type) {
+      case OP_FILL_SCREEN:
+        gfx.fillScreen(op.color);
+        break;
+      case OP_FILL_RECT:
+        gfx.fillRect(op.x, op.y, op.w, op.h, op.color);
+        break;
+      case OP_DRAW_RECT:
+        gfx.drawRect(op.x, op.y, op.w, op.h, op.color);
+        break;
+      case OP_LINE:
+        gfx.drawLine(op.x, op.y, op.w, op.h, op.color);
+        break;
+      case OP_BITMAP:
+        gfx.drawBitmap(op.x, op.y, (const uint8_t*)op.data, op.w, op.h, op.color);
+        break;
+      case OP_TEXT:
+        gfx.setFont((const GFXfont*)op.data);
+        gfx.setTextColor(op.color);
+        gfx.setCursor(op.x, op.y);
+        gfx.print(text_[nextText++]);
+        break;
+      case OP_DRAW:
+        draws_[(uintptr_t)op.data](gfx);
+        break;
+    }
+  }
+}
@@ -0,0 +1,395 @@
+#include <pocketmage.h>
+#include <SD_MMC.h>
+#include <sd_chunk_reader.h>
+
+static constexpr const char* tag = "IMAGE";
+
+static constexpr uint16_t VIEW_W   = 320;
+static constexpr uint16_t VIEW_H   = 240;
+static constexpr uint32_t MAX_SIDE = 65535;   // Keeps the box filter sums in range
+
+static constexpr uint8_t BAYER_8X8[8][8] = {
+  { 0, 32,  8, 40,  2, 34, 10, 42},
+  {48, 16, 56, 24, 50, 18, 58, 26},
+  {12, 44,  4, 36, 14, 46,  6, 38},
+  {60, 28, 52, 20, 62, 30, 54, 22},
+  { 3, 35, 11, 43,  1, 33,  9, 41},
+  {51, 19, 59, 27, 49, 17, 57, 25},
+  {15, 47,  7, 39, 13, 45,  5, 37},
+  {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+// ===================== raster =====================
+// Takes gray source pixels in file order and draws dithered output rows. Source pixel x covers
+// output columns [x * outW / srcW, (x + 1) * outW / srcW), at least one, so shrinking averages
+// a box of pixels and enlarging repeats them; rows map the same way.
+class ImageRaster {
+public:
+  ImageRaster(uint32_t srcW, uint32_t srcH, bool bottomUp, ImageDither dither, Adafruit_GFX& gfx)
+      : srcW_(srcW), srcH_(srcH), bottomUp_(bottomUp), dither_(dither), gfx_(gfx) {
+    // Fit inside the view, keeping the aspect ratio
+    if ((uint64_t)srcW * VIEW_H >= (uint64_t)srcH * VIEW_W) {
+      outW_ = VIEW_W;
+      outH_ = max<uint32_t>(1, (uint64_t)srcH * VIEW_W / srcW);
+    } else {
+      outH_ = VIEW_H;
+      outW_ = max<uint32_t>(1, (uint64_t)srcW * VIEW_H / srcH);
+    }
+    x0_ = (VIEW_W - outW_) / 2;
+    y0_ = (VIEW_H - outH_) / 2;
+    clearSums_();
+    memset(err_, 0, sizeof(err_));
+  }
+
+  void pixel(uint8_t gray) {
+    const uint16_t from = col_;
+    colAcc_ += outW_;
+    while (colAcc_ >= srcW_) {
+      colAcc_ -= srcW_;
+      col_++;
+    }
+    const uint16_t to = max<uint16_t>(col_, from + 1);
+    for (uint16_t c = from; c < to; c++) {
+      sum_[c] += gray;
+      n_[c]++;
+    }
+  }
+
+  void endRow() {
+    col_    = 0;
+    colAcc_ = 0;
+
+    const uint16_t from = row_;
+    rowAcc_ += outH_;
+    while (rowAcc_ >= srcH_) {
+      rowAcc_ -= srcH_;
+      row_++;
+    }
+    if (row_ == from) return;   // Output row still collecting source rows
+    for (uint16_t r = from; r < row_; r++) emit_(r);
+    clearSums_();
+  }
+
+private:
+  void clearSums_() {
+    memset(sum_, 0, sizeof(sum_));
+    memset(n_, 0, sizeof(n_));
+  }
+
+  void emit_(uint16_t r) {
+    uint8_t gray[VIEW_W];
+    for (uint16_t c = 0; c < outW_; c++) gray[c] = n_[c] ? sum_[c] / n_[c] : 255;
+
+    memset(bits_, 0, sizeof(bits_));
+    if (dither_ == DITHER_ORDERED) {
+      for (uint16_t c = 0; c < outW_; c++) {
+        if (gray[c] < BAYER_8X8[r & 7][c & 7] * 4 + 2) bits_[c >> 3] |= 0x80 >> (c & 7);
+      }
+    } else {
+      floydSteinberg_(gray, r);
+    }
+
+    const uint16_t y = bottomUp_ ? outH_ - 1 - r : r;
+    gfx_.drawBitmap(x0_, y0_ + y, bits_, outW_, 1, GxEPD_BLACK);
+  }
+
+  // Serpentine, in 1/16ths; err_[0] is this row's incoming error, err_[1] the next row's
+  void floydSteinberg_(const uint8_t* gray, uint16_t r) {
+    int32_t* cur  = err_[0] + 1;
+    int32_t* next = err_[1] + 1;
+    const int dir = (r & 1) ? -1 : 1;
+    for (uint16_t i = 0; i < outW_; i++) {
+      const int     c     = dir > 0 ? i : outW_ - 1 - i;
+      const int32_t v     = gray[c] + (cur[c] >> 4);
+      const bool    black = v < 128;
+      const int32_t e     = v - (black ? 0 : 255);
+      if (black) bits_[c >> 3] |= 0x80 >> (c & 7);
+      cur[c + dir]  += e * 7;
+      next[c - dir] += e * 3;
+      next[c]       += e * 5;
+      next[c + dir] += e;
+    }
+    memcpy(err_[0], err_[1], sizeof(err_[0]));
+    memset(err_[1], 0, sizeof(err_[1]));
+  }
+
+  const uint32_t srcW_;
+  const uint32_t srcH_;
+  const bool     bottomUp_;
+  ImageDither    dither_;
+  Adafruit_GFX&  gfx_;
+  uint16_t       outW_;
+  uint16_t       outH_;
+  uint16_t       x0_;
+  uint16_t       y0_;
+  uint16_t       col_    = 0;
+  uint32_t       colAcc_ = 0;
+  uint16_t       row_    = 0;
+  uint32_t       rowAcc_ = 0;
+  uint32_t       sum_[VIEW_W];
+  uint32_t       n_[VIEW_W];
+  int32_t        err_[2][VIEW_W + 2];   // One spare column each side
+  uint8_t        bits_[VIEW_W / 8];
+};
+
+static std::unique_ptr<ImageRaster> makeRaster(uint32_t w, uint32_t h, bool bottomUp,
+                                               ImageDither dither, Adafruit_GFX& gfx) {
+  if (w == 0 || h == 0 || w > MAX_SIDE || h > MAX_SIDE) {
+    ESP_LOGE(tag, "Bad size %ux%u", (unsigned)w, (unsigned)h);
+    return nullptr;
+  }
+  std::unique_ptr<ImageRaster> raster(new (std::nothrow) ImageRaster(w, h, bottomUp, dither, gfx));
+  if (!raster) ESP_LOGE(tag, "No memory for row buffers");
+  return raster;
+}
+
+// ===================== PBM / PGM =====================
+static int skipPnmSpace(ChunkReader& in) {
+  int c = in.read();
+  for (;;) {
+    if (c == '#') {
+      while (c >= 0 && c != '\n') c = in.read();
+    } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      c = in.read();
+    } else {
+      return c;
+    }
+  }
+}
+
+// Next decimal number, skipping whitespace and comments; also consumes the byte after it,
+// which ends the header before binary samples
+static bool pnmNumber(ChunkReader& in, uint32_t& value) {
+  int c = skipPnmSpace(in);
+  if (c < '0' || c > '9') return false;
+  value = 0;
+  for (; c >= '0' && c <= '9'; c = in.read()) {
+    value = value * 10 + (c - '0');
+    if (value > 0xFFFFFF) return false;
+  }
+  return true;
+}
+
+static bool drawPnm(ChunkReader& in, char kind, ImageDither dither, Adafruit_GFX& gfx) {
+  const bool bitmap = kind == '1' || kind == '4';
+  uint32_t   w, h, maxval = 1;
+  if (!pnmNumber(in, w) || !pnmNumber(in, h) || (!bitmap && !pnmNumber(in, maxval)) ||
+      maxval == 0 || maxval > 65535) {
+    ESP_LOGE(tag, "Bad P%c header", kind);
+    return false;
+  }
+
+  std::unique_ptr<ImageRaster> raster = makeRaster(w, h, false, dither, gfx);
+  if (!raster) return false;
+
+  for (uint32_t y = 0; y < h; y++) {
+    uint8_t bits = 0;
+    for (uint32_t x = 0; x < w; x++) {
+      uint32_t sample;
+      switch (kind) {
+        case '1': {   // Digits, separators optional
+          const int c = skipPnmSpace(in);
+          if (c != '0' && c != '1') return false;
+          sample = c - '0';
+          break;
+        }
+        case '4': {   // MSB first, rows padded to a byte
+          if ((x & 7) == 0) {
+            const int c = in.read();
+            if (c < 0) return false;
+            bits = c;
+          }
+          sample = (bits >> (7 - (x & 7))) & 1;
+          break;
+        }
+        case '2':
+          if (!pnmNumber(in, sample)) return false;
+          break;
+        default: {    // P5, big-endian when maxval needs two bytes
+          const int hi = in.read();
+          if (hi < 0) return false;
+          sample = hi;
+          if (maxval > 255) {
+            const int lo = in.read();
+            if (lo < 0) return false;
+            sample = (sample << 8) | lo;
+          }
+          break;
+        }
+      }
+      // PBM 1 is black; PGM maxval is white
+      raster->pixel(bitmap ? (sample ? 0 : 255) : min(sample, maxval) * 255 / maxval);
+    }
+    raster->endRow();
+  }
+  return true;
+}
+
+// ===================== BMP =====================
+// Extracts one channel of a 16 or 32 bit pixel as 0-255
+struct BmpChannel {
+  uint32_t mask;
+  uint8_t  shift;
+  uint32_t max;
+
+  explicit BmpChannel(uint32_t m) : mask(m), shift(0), max(1) {
+    if (!m) return;
+    while (!(m & 1)) {
+      m >>= 1;
+      shift++;
+    }
+    max = m;
+  }
+  uint8_t operator()(uint32_t px) const { return mask ? ((px & mask) >> shift) * 255 / max : 0; }
+};
+
+static uint8_t luma(uint8_t r, uint8_t g, uint8_t b) {
+  return (r * 77 + g * 150 + b * 29) >> 8;
+}
+
+static bool drawBmp(ChunkReader& in, ImageDither dither, Adafruit_GFX& gfx) {
+  // File header, then the start of the info header; older 12 byte core headers are not read
+  uint8_t fh[14];
+  uint8_t ih[52] = {};
+  if (in.read(fh, sizeof(fh)) != sizeof(fh) || fh[0] != 'B' || fh[1] != 'M' ||
+      in.read(ih, 4) != 4) {
+    ESP_LOGE(tag, "Not a BMP file");
+    return false;
+  }
+  const uint32_t dataOffset = le32(fh + 10);
+  const uint32_t headerSize = le32(ih);
+  if (headerSize < 40) {
+    ESP_LOGE(tag, "Unsupported BMP header size %u", (unsigned)headerSize);
+    return false;
+  }
+  const uint32_t kept = min<uint32_t>(headerSize, sizeof(ih));
+  if (in.read(ih + 4, kept - 4) != kept - 4 || !in.skip(headerSize - kept)) return false;
+  uint32_t consumed = sizeof(fh) + headerSize;
+
+  const int32_t  w           = (int32_t)le32(ih + 4);
+  const int32_t  h           = (int32_t)le32(ih + 8);
+  const uint16_t bpp         = le16(ih + 14);
+  const uint32_t compression = le32(ih + 16);
+  const uint32_t colorsUsed  = le32(ih + 32);
+
+  // BI_RGB, or BI_BITFIELDS with the masks in or right after the header
+  uint32_t masks[3] = {0x7C00, 0x03E0, 0x001F};
+  if (bpp == 32) {
+    masks[0] = 0xFF0000;
+    masks[1] = 0x00FF00;
+    masks[2] = 0x0000FF;
+  }
+  if (compression == 3 && (bpp == 16 || bpp == 32)) {
+    if (headerSize == 40) {
+      if (in.read(ih + 40, 12) != 12) return false;
+      consumed += 12;
+    }
+    for (uint8_t i = 0; i < 3; i++) masks[i] = le32(ih + 40 + 4 * i);
+  } else if (compression != 0) {
+    ESP_LOGE(tag, "Compressed BMPs are not supported");
+    return false;
+  }
+  if (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32) {
+    ESP_LOGE(tag, "Unsupported BMP depth %u", bpp);
+    return false;
+  }
+  const BmpChannel red(masks[0]), green(masks[1]), blue(masks[2]);
+
+  uint8_t palette[256];
+  if (bpp <= 8) {
+    const uint32_t entries = colorsUsed ? colorsUsed : 1UL << bpp;
+    if (entries > 256) {
+      ESP_LOGE(tag, "Bad BMP palette size %u", (unsigned)entries);
+      return false;
+    }
+    for (uint32_t i = 0; i < entries; i++) {
+      uint8_t bgrx[4];
+      if (in.read(bgrx, 4) != 4) return false;
+      palette[i] = luma(bgrx[2], bgrx[1], bgrx[0]);
+    }
+    for (uint32_t i = entries; i < 256; i++) palette[i] = 0;
+    consumed += entries * 4;
+  }
+  if (dataOffset > consumed && !in.skip(dataOffset - consumed)) return false;
+
+  const uint32_t width  = w < 0 ? 0 : w;
+  const uint32_t height = h < 0 ? -(int64_t)h : h;
+  std::unique_ptr<ImageRaster> raster = makeRaster(width, height, h > 0, dither, gfx);
+  if (!raster) return false;
+
+  const uint32_t stride = ((uint64_t)width * bpp + 31) / 32 * 4;
+  for (uint32_t y = 0; y < height; y++) {
+    uint32_t used = 0;
+    uint8_t  bits = 0;
+    for (uint32_t x = 0; x < width; x++) {
+      uint8_t px[4];
+      uint8_t gray;
+      if (bpp < 8) {   // MSB first
+        const uint8_t perByte = 8 / bpp;
+        if (x % perByte == 0) {
+          const int c = in.read();
+          if (c < 0) return false;
+          bits = c;
+          used++;
+        }
+        const uint8_t shift = 8 - bpp * (x % perByte + 1);
+        gray = palette[(bits >> shift) & ((1 << bpp) - 1)];
+      } else {
+        const uint8_t bytes = bpp / 8;
+        if (in.read(px, bytes) != bytes) return false;
+        used += bytes;
+        switch (bpp) {
+          case 8:  gray = palette[px[0]]; break;
+          case 24: gray = luma(px[2], px[1], px[0]); break;
+          case 16: {
+            const uint32_t v = le16(px);
+            gray = luma(red(v), green(v), blue(v));
+            break;
+          }
+          default: {
+            const uint32_t v = le32(px);
+            gray = luma(red(v), green(v), blue(v));
+            break;
+          }
+        }
+      }
+      raster->pixel(gray);
+    }
+    if (!in.skip(stride - used)) return false;
+    raster->endRow();
+  }
+  return true;
+}
+
+// ===================== public =====================
+bool isImageFile(const String& path) {
+  String lower = path;
+  lower.toLowerCase();
+  return lower.endsWith(".bmp") || lower.endsWith(".pbm") || lower.endsWith(".pgm");
+}
+
+bool drawImageFile(const String& path, Adafruit_GFX& gfx, ImageDither dither) {
+  File file = SD_MMC.open(path);
+  if (!file) return false;
+
+  ChunkReader in(file);
+  bool        ok;
+  String      lower = path;
+  lower.toLowerCase();
+  if (lower.endsWith(".bmp")) {
+    ok = drawBmp(in, dither, gfx);
+  } else {
+    const int p    = in.read();
+    const int kind = in.read();
+    const bool pbm = lower.endsWith(".pbm");
+    ok = p == 'P' && (pbm ? (kind == '1' || kind == '4') : (kind == '2' || kind == '5')) &&
+         drawPnm(in, kind, dither, gfx);
+  }
+  file.close();
+
+  if (!ok) ESP_LOGE(tag, "Could not draw %s", path.c_str());
+  return ok;
+}
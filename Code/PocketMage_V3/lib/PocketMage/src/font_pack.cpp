@@ -0,0 +1,166 @@
+#include <pocketmage.h>
+#include <SD_MMC.h>
+
+static constexpr const char* tag = "FONTS";
+
+static constexpr size_t PMF_HEADER      = 12;
+static constexpr size_t PMF_GLYPH       = 8;
+static constexpr size_t PMF_MAX_BITMAP  = 256 * 1024;   // Far beyond any sensible e-ink font
+
+static FontPack pm_fonts;
+
+FontPack& FONTS() { return pm_fonts; }
+
+static String fontPath(const String& name) {
+  return String(FONTS_DIR) + "/" + name + ".pmf";
+}
+
+// Lock held for the rest of the scope; a no-op before the first find()
+class FontLock {
+public:
+  explicit FontLock(SemaphoreHandle_t lock) : lock_(lock) {
+    if (lock_) xSemaphoreTake(lock_, portMAX_DELAY);
+  }
+  ~FontLock() {
+    if (lock_) xSemaphoreGive(lock_);
+  }
+
+private:
+  SemaphoreHandle_t lock_;
+};
+
+// ===================== FONT PACK =====================
+int FontPack::find(const char* name) {
+  if (!lock_) lock_ = xSemaphoreCreateMutex();
+  FontLock lock(lock_);
+
+  for (size_t i = 0; i < slots_.size(); i++) {
+    if (slots_[i]->name == name) {
+      slots_[i]->failed = false;   // The file may have been replaced
+      return i;
+    }
+  }
+  if (!SD_MMC.exists(fontPath(name))) return -1;
+
+  Slot* slot    = new Slot();
+  slot->name    = name;
+  slot->font    = GFXfont{nullptr, nullptr, 1, 0, 0};
+  slot->data    = nullptr;
+  slot->size    = 0;
+  slot->lastUse = 0;
+  slot->failed  = false;
+  slots_.push_back(slot);
+  return slots_.size() - 1;
+}
+
+const GFXfont* FontPack::use(int slot) {
+  FontLock lock(lock_);
+  if (slot < 0 || slot >= (int)slots_.size()) return nullptr;
+
+  Slot& s = *slots_[slot];
+  s.lastUse = ++useTick_;
+  if (!s.data && (s.failed || !load_(s))) {
+    s.failed = true;
+    return nullptr;
+  }
+  return &s.font;
+}
+
+// Unload the least recently used fonts over budget, skipping any used since the last trim
+void FontPack::trim() {
+  FontLock lock(lock_);
+  const size_t budget = (psramFound() ? FONT_CACHE_PSRAM_KB : FONT_CACHE_KB) * 1024UL;
+  while (bytes_ > budget) {
+    Slot* oldest = nullptr;
+    for (Slot* s : slots_) {
+      if (!s->data || s->lastUse > lastTrim_) continue;
+      if (!oldest || s->lastUse < oldest->lastUse) oldest = s;
+    }
+    if (!oldest) break;
+
+    ESP_LOGD(tag, "Unloading %s", oldest->name.c_str());
+    unload_(*oldest);
+  }
+  lastTrim_ = useTick_;
+}
+
+void FontPack::clear() {
+  FontLock lock(lock_);
+  for (Slot* s : slots_) {
+    unload_(*s);
+    s->failed = false;
+  }
+}
+
+bool FontPack::load_(Slot& slot) {
+  File file = SD_MMC.open(fontPath(slot.name));
+  if (!file) return false;
+
+  uint8_t header[PMF_HEADER];
+  if (file.read(header, sizeof(header)) != sizeof(header) || memcmp(header, "PMF1", 4) != 0) {
+    ESP_LOGE(tag, "Not a PMF1 file: %s", slot.name.c_str());
+    file.close();
+    return false;
+  }
+  const uint8_t first      = header[4];
+  const uint8_t last       = header[5];
+  const uint8_t yAdvance   = header[6];
+  const size_t  bitmapSize = header[8] | (header[9] << 8) | ((uint32_t)header[10] << 16) |
+                             ((uint32_t)header[11] << 24);
+  if (last < first || bitmapSize > PMF_MAX_BITMAP) {
+    ESP_LOGE(tag, "Bad header: %s", slot.name.c_str());
+    file.close();
+    return false;
+  }
+
+  const size_t count     = last - first + 1;
+  const size_t glyphSize = count * sizeof(GFXglyph);
+  const size_t size      = glyphSize + bitmapSize;
+  uint8_t*     data      = (uint8_t*)(psramFound() ? ps_malloc(size) : malloc(size));
+  if (!data) {
+    ESP_LOGE(tag, "No memory for %s (%u bytes)", slot.name.c_str(), (unsigned)size);
+    file.close();
+    return false;
+  }
+
+  GFXglyph* glyphs = (GFXglyph*)data;
+  uint8_t*  bitmap = data + glyphSize;
+  bool      ok     = true;
+  for (size_t i = 0; i < count && ok; i++) {
+    uint8_t g[PMF_GLYPH];
+    ok = file.read(g, sizeof(g)) == sizeof(g);
+    glyphs[i].bitmapOffset = g[0] | (g[1] << 8);
+    glyphs[i].width        = g[2];
+    glyphs[i].height       = g[3];
+    glyphs[i].xAdvance     = g[4];
+    glyphs[i].xOffset      = (int8_t)g[5];
+    glyphs[i].yOffset      = (int8_t)g[6];
+    ok = ok && glyphs[i].bitmapOffset + (glyphs[i].width * glyphs[i].height + 7) / 8 <= bitmapSize;
+  }
+  ok = ok && file.read(bitmap, bitmapSize) == bitmapSize;
+  file.close();
+  if (!ok) {
+    ESP_LOGE(tag, "Truncated or corrupt: %s", slot.name.c_str());
+    free(data);
+    return false;
+  }
+
+  slot.data = data;
+  slot.size = size;
+  slot.font = GFXfont{bitmap, glyphs, first, last, yAdvance};
+  bytes_ += size;
+  ESP_LOGD(tag, "Loaded %s (%u bytes)", slot.name.c_str(), (unsigned)size);
+  return true;
+}
+
+void FontPack::unload_(Slot& slot) {
+  if (!slot.data) return;
+  // A reload lands at the same address with a new range and bitmap
+  GLYPHS().forget(&slot.font);
+  // Reads as a font without glyphs until it is loaded again
+  slot.font = GFXfont{nullptr, nullptr, 1, 0, slot.font.yAdvance};
+  free(slot.data);
+  slot.data = nullptr;
+  bytes_ -= slot.size;
+  slot.size = 0;
+}
@@ -13,34 +13,36 @@ int currentFrameChoice = -1;
 int frameSelection = 0;
 
 #pragma region frameSetup
+// shared dynamic text for frames, takes no memory until the first line is pushed
+ArenaSource frameLines;
+
+PROGMEM_TEXT_SOURCE(testTextSrc,
+  "This is the first line.",
+  "This is a test frame.",
+  "It supports multiple lines of text.",
+  "You can add as many lines as you want.",
+  "Frames can also have boxes and cursors.",
+  "This is a test frame.",
+  "It supports multiple lines of text.",
+  "You can add as many lines as you want.",
+  "Frames can also have boxes and cursors.",
+  "This is a test frame.",
+  "It supports multiple lines of text.",
+  "You can add as many lines as you want.",
+  "Frames can also have boxes and cursors.",
+  "This is a test frame.",
+  "It supports multiple lines of text.",
+  "You can add as many lines as you want.",
+  "Frames can also have boxes and cursors.",
+  "This is the last line."
+);
+
 Frame testTextScreen(
   FRAME_LEFT, 
   FRAME_RIGHT, 
   FRAME_TOP, 
   FRAME_BOTTOM,
-  new ProgmemTableSource(
-    (const char* const[]){
-      "This is the first line.",
-      "This is a test frame.",
-      "It supports multiple lines of text.",
-      "You can add as many lines as you want.",
-      "Frames can also have boxes and cursors.",
-      "This is a test frame.",
-      "It supports multiple lines of text.",
-      "You can add as many lines as you want.",
-      "Frames can also have boxes and cursors.",
-      "This is a test frame.",
-      "It supports multiple lines of text.",
-      "You can add as many lines as you want.",
-      "Frames can also have boxes and cursors.",
-      "This is a test frame.",
-      "It supports multiple lines of text.",
-      "You can add as many lines as you want.",
-      "Frames can also have boxes and cursors.",
-      "This is the last line."
-    },
-    5
-  ),
+  &testTextSrc,
   true,   // cursor
   true    // box
 );
@@ -85,14 +87,17 @@ Frames Class:
     frames point to 3 different types of sources: a fixed arena source (dynamic content), a progremmem table (static text), and a bitmap (static image)
   
   Usage:
-    einkFramesDynamic(std::vector<Frame*> &frames, bool doFull_) // draws all frames in std::vector<Frame *> frames
+    einkFramesDynamic(std::vector<Frame*> &frames, bool doFull_) // draws the frames in std::vector<Frame *> frames that changed since the last call (all of them if doFull_)
+    frame.markDirty(); // force a frame to redraw, e.g. after editing a TextSource that has no revision()
     updateScroll(Frame *currentFrameState,int prevScroll,int currentScroll, bool reset) // updates individual frame's scroll from scrollDynamic and prevScrollDynamic
 
     frames.clear(); // remove all frames stored in std::vector<frame *> frames
     frames.push_back(frame *); // add the frames you want to draw NOTE: frames pushed back earlier will be drawn over if new frames have overlap set to true
     CurrentFrameState = &frame; // point to current frame you want to control, can switch at any point to control different frames
 
-    frameLines.pushLine(s.c_str(), (uint16_t)s.length(), flag); // push line to a dynamic text source, flag currently not implemented
+    frameLines.pushLine(s.c_str(), (uint16_t)s.length(), flag); // push line to a dynamic text source (allocated on first use, grows as needed)
+    frameLines.release(); // free its memory when no frame shows it
+    PROGMEM_TEXT_SOURCE(name, "line", ...); // static text table with lengths computed at compile time
 
     std::vector<String> sourceToVector(const TextSource* src); // export frame text source to std::vector<String> for compatibility 
 */
@@ -141,6 +146,49 @@ size_t sliceThatFits(const char* s, size_t n, int maxTextWidth) {
   }
   return best;
 }
+// ARENA SOURCE STORAGE !!
+LineView ArenaSource::line(size_t i) const {
+  const Entry& e = entries_[i];
+  return { buf_ + e.off, e.len, e.flags };
+}
+bool ArenaSource::reserve_(size_t lines, size_t bytes) {
+  if (lines > lineCap_) {
+    size_t cap = max<size_t>(lineCap_ * 2, 32);
+    cap = min(max(cap, lines), maxLines_);
+    void* p = psramFound() ? ps_realloc(entries_, cap * sizeof(Entry)) : realloc(entries_, cap * sizeof(Entry));
+    if (!p) return false;
+    entries_ = (Entry*)p;
+    lineCap_ = cap;
+  }
+  if (bytes > bufCap_) {
+    size_t cap = max<size_t>(bufCap_ * 2, 1024);
+    cap = min(max(cap, bytes), maxBytes_);
+    void* p = psramFound() ? ps_realloc(buf_, cap) : realloc(buf_, cap);
+    if (!p) return false;
+    buf_    = (char*)p;
+    bufCap_ = cap;
+  }
+  return true;
+}
+bool ArenaSource::pushLine(const char* s, uint16_t L, uint8_t flags) {
+  if (nLines_ >= maxLines_ || used_ + L + 1 > maxBytes_) return false;
+  if (!reserve_(nLines_ + 1, used_ + L + 1)) return false;
+  memcpy(buf_ + used_, s, L);
+  buf_[used_ + L]   = '\0';
+  entries_[nLines_] = { (uint32_t)used_, L, flags };
+  used_            += L + 1;
+  nLines_++;
+  rev_++;
+  return true;
+}
+void ArenaSource::release() {
+  free(buf_);
+  free(entries_);
+  buf_     = nullptr;
+  entries_ = nullptr;
+  bufCap_  = lineCap_ = 0;
+  clear();
+}
 // GET TOTAL LINES OF SOURCE !!
 inline long totalLines(const Frame& frame) {
   return frame.source ? (long)frame.source->size() : 0L;
@@ -164,6 +212,27 @@ inline size_t trimCRLF(const char* s, size_t n) {
   return n;
 }
 
+// WRAP POINTS OF ONE SOURCE LINE, MEASURED THE FIRST TIME IT IS NEEDED !!
+static const Frame::Wraps& lineWraps(Frame& frame, long line, int maxTextWidth) {
+  Frame::Wraps& w = frame.wraps[line];
+  if (w.first >= 0) return w;
+
+  LineView lv = frame.source->line(line);
+  const size_t effLen = trimCRLF(lv.ptr, lv.len);
+  w.first = (int32_t)frame.wrapStarts.size();
+  w.len   = (uint16_t)effLen;
+  size_t pos = 0;
+  while (pos < effLen) {
+    size_t take = sliceThatFits(lv.ptr + pos, effLen - pos, maxTextWidth);
+    if (take == 0) break;
+    frame.wrapStarts.push_back((uint16_t)pos);
+    w.count++;
+    pos += take;
+  }
+  // a line that stopped early ends there
+  if (pos < effLen) w.len = (uint16_t)pos;
+  return w;
+}
 // MAKE SURE CHOICE IS VISIBLE IN FRAME --
 void ensureChoiceVisible(Frame& frame) {
   long T = frame.source ? (long)frame.source->size() : 0L;
@@ -208,149 +277,224 @@ std::vector<String> sourceToVector(const TextSource* src) {
 #pragma endregion
 
 ///////////////////////////// DRAWING FUNCTIONS
-// DRAW ALL FRAMES STORED WITHIN TOTAL FRAME BOUNDING BOX -- NOTE: remove ~C~ and ~R~ with switch to lineview flags
-void einkFramesDynamic(std::vector<Frame*> &frames, bool doFull_) {
-  if (frames.empty()) return;
-
-  // compute union window of all frames
-  int minX =  32767, minY =  32767;
-  int maxX = -32768, maxY = -32768;
-  for (Frame* frame : frames) {
-    if (!frame) continue;
-    const int width = display.width()  - frame->left  - frame->right;
-    const int height = display.height() - frame->top   - frame->bottom;
-    if (width <= 0 || height <= 0) continue;
-    if (frame->left < minX) minX = frame->left;
-    if (frame->top  < minY) minY = frame->top;
-    if (frame->left + width > maxX) maxX = frame->left + width;
-    if (frame->top  + height > maxY) maxY = frame->top  + height;
+// FRAME AREA ON SCREEN !!
+static EinkRect frameBox(const Frame& frame) {
+  return { (int16_t)frame.left, (int16_t)frame.top,
+           (int16_t)(display.width()  - frame.left - frame.right),
+           (int16_t)(display.height() - frame.top  - frame.bottom) };
+}
+// SCROLL, CHOICE AND WRAPPED ROWS OF A TEXT FRAME, RE-WRAPPING ONLY WHEN ITS VISIBLE LINES CHANGED !!
+static void layoutFrame(Frame& frame) {
+  if (!frame.hasText()) return;
+  const EinkRect box = frameBox(frame);
+  const int lineStride = EINK().getFontHeight() + EINK().getLineSpacing();
+
+  frame.maxLines = (lineStride > 1) ? (box.h / lineStride) - 1 : 0;
+  if (frame.maxLines <= 0) {
+    frame.rows.clear();
+    frame.rowsStart = frame.rowsEnd = -1;
+    return;
   }
-  if (minX > maxX || minY > maxY) return;
 
-  const int frameX = minX;
-  const int frameY = alignDown8(minY);
-  const int frameW = alignUp8(maxX - minX);
-  const int frameH = alignDown8(maxY - frameY);
-
-  EINK().setTXTFont(EINK().getCurrentFont());
+  const long total  = (long)frame.source->size();
+  clampScroll(frame);
 
-  display.setPartialWindow(frameX, frameY, frameW, frameH);
-  display.firstPage();
-  do {
-    if (doFull_) {
-      display.fillRect(frameX, frameY, frameW, frameH, GxEPD_WHITE);
-    }
-    //Serial.println("Drawing Text!");
-    for (Frame* frame : frames) {
-      if (!frame || (!frame->source && !frame->bitmap)) continue;
-
-      const int frameW = display.width()  - frame->left - frame->right;
-      const int frameH = display.height() - frame->top  - frame->bottom;
-      if (frameW <= 0 || frameH <= 0) continue;
-
-      // if frame overlaps or is inverted, fill box with proper color
-      if (frame->invert || frame->overlap) {
-        display.fillRect(frame->left, frame->top, frameW, frameH,
-                        frame->invert ? GxEPD_BLACK : GxEPD_WHITE);
-      }
-
-      if (frame->box) {
-        //Serial.println("drawing box!");
-        if (frameW > 2 && frameH > 2) {
-          drawFrameBox(frame->left + 1, frame->top + 1, frameW - 2, frameH - 2,frame->invert);
-        }
-      }
-      if (frame->bitmap) {
-
-        if (frame->bitmapW <= frameW && frame->bitmapH <= frameH) {
-
-          const uint16_t bitColor = frame->invert ? GxEPD_WHITE : GxEPD_BLACK;
-          if (frame->bitmapW <= frameW && frame->bitmapH <= frameH) {
-              int x = frame->left + (frameW - frame->bitmapW) / 2;
-              int y = frame->top  + (frameH - frame->bitmapH) / 2;
-              display.drawBitmap(x, y, frame->bitmap, frame->bitmapW, frame->bitmapH, bitColor);
-          }
-
-        }
-
-        continue;
-      }
-      const int lineStride = EINK().getFontHeight() + EINK().getLineSpacing();
-
-      frame->maxLines = (lineStride > 1) ? (frameH / lineStride) - 1 : 0;
-      if (frame->maxLines <= 0) continue;
-
-      const long total  = frame->source ? (long)frame->source->size() : 0L;
-      clampScroll(*frame);
-
-      if (frame == CurrentFrameState && frame->choice >= 0) {
-        ensureChoiceVisible(*frame);
-      }
-      // initialize lastTotal on first draw
-      if (frame->lastTotal < 0) frame->lastTotal = total;
-
-      // remember if user was pinned to bottom before we adjust
-      const bool wasPinnedToBottom = (frame->scroll == 0);
+  if (&frame == CurrentFrameState && frame.choice >= 0) {
+    ensureChoiceVisible(frame);
+  }
+  // initialize lastTotal on first draw
+  if (frame.lastTotal < 0) frame.lastTotal = total;
+
+  // remember if user was pinned to bottom before we adjust
+  const bool wasPinnedToBottom = (frame.scroll == 0);
+
+  // if maxLines shrank or list shrank, clamp scroll
+  clampScroll(frame);
+
+  // if user is at bottom, keep them there when lines grow
+  if (wasPinnedToBottom) frame.scroll = 0;
+
+  // update last seen count
+  frame.lastTotal = total;
+  long startLine = 0, endLine = 0;
+  getVisibleRange(&frame, total, startLine, endLine); 
+  // force the visible window to the selected line when only one line fits
+  if (frame.maxLines <= 1 && frame.choice >= 0 && frame.choice < total) {
+    startLine = frame.choice;
+    endLine   = frame.choice + 1; 
+  }
 
-      // if maxLines shrank or list shrank, clamp scroll
-      clampScroll(*frame);
+  const uint32_t revision = frame.source->revision();
+  if (frame.rowsSource == frame.source && frame.rowsRevision == revision &&
+      frame.rowsFont == EINK().getCurrentFont() && frame.rowsWidth == box.w &&
+      frame.rowsStart == startLine && frame.rowsEnd == endLine) return;
+
+  // wrap points stay valid until the text, font or width changes
+  if (frame.wrapSource != frame.source || frame.wrapRevision != revision ||
+      frame.wrapFont != EINK().getCurrentFont() || frame.wrapWidth != box.w) {
+    frame.wraps.assign(total, Frame::Wraps());
+    frame.wrapStarts.clear();
+    frame.wrapSource   = frame.source;
+    frame.wrapRevision = revision;
+    frame.wrapFont     = EINK().getCurrentFont();
+    frame.wrapWidth    = box.w;
+  }
 
-      // if user is at bottom, keep them there when lines grow
-      if (wasPinnedToBottom) frame->scroll = 0;
+  frame.rows.clear();
+  for (long line = startLine; line < endLine; ++line) {
+    const Frame::Wraps& w = lineWraps(frame, line, box.w);
+    // blank lines still take a row
+    if (w.count == 0) { frame.rows.push_back({ (uint16_t)line, 0, 0 }); continue; }
 
-      // update last seen count
-      frame->lastTotal = total;
-      long startLine = 0, endLine = 0;
-      // now get the visible range with the reconciled values
+    for (uint16_t k = 0; k < w.count; ++k) {
+      const uint16_t pos = frame.wrapStarts[w.first + k];
+      const uint16_t end = (k + 1 < w.count) ? frame.wrapStarts[w.first + k + 1] : w.len;
+      frame.rows.push_back({ (uint16_t)line, pos, (uint16_t)(end - pos) });
+    }
+  }
 
+  frame.rowsSource   = frame.source;
+  frame.rowsRevision = revision;
+  frame.rowsFont     = EINK().getCurrentFont();
+  frame.rowsWidth    = box.w;
+  frame.rowsStart    = startLine;
+  frame.rowsEnd      = endLine;
+  frame.dirty        = true;
+}
+// PART OF A FRAME THAT DIFFERS FROM WHAT IS ON SCREEN, EMPTY IF NOTHING !!
+static EinkRect changedArea(const Frame& frame) {
+  const EinkRect box = frameBox(frame);
+  const bool moved = frame.left != frame.drawnLeft || frame.right  != frame.drawnRight ||
+                     frame.top  != frame.drawnTop  || frame.bottom != frame.drawnBottom;
+
+  if (frame.dirty || moved || frame.bitmap != frame.drawnBitmap) {
+    EinkRect area = box;
+    if (moved && frame.drawnLeft >= 0) {
+      area.merge({ (int16_t)frame.drawnLeft, (int16_t)frame.drawnTop,
+                   (int16_t)(display.width()  - frame.drawnLeft - frame.drawnRight),
+                   (int16_t)(display.height() - frame.drawnTop  - frame.drawnBottom) });
+    }
+    return area;
+  }
 
-      const int maxTextWidth = frameW;
-      int outLine = 0;
-      getVisibleRange(frame, total, startLine, endLine); 
-      // force the visible window to the selected line when only one line fits
-      if (frame->maxLines <= 1 && frame->choice >= 0 && frame->choice < total) {
-        startLine = frame->choice;
-        endLine   = frame->choice + 1; 
-      }
-      for (long line = startLine; line < endLine; ++line) {
-        LineView lv = frame->source->line(line);
-        size_t effLen = trimCRLF(lv.ptr, lv.len);
-        if (effLen == 0) { ++outLine; continue; }
+  // only the selection moved: the rows it left and the row it landed on, with a row of margin
+  // for glyphs that reach past their own row
+  EinkRect area;
+  const bool isCurrent = (&frame == CurrentFrameState);
+  if ((frame.choice != frame.drawnChoice || isCurrent != frame.drawnCurrent) && frame.hasText()) {
+    const int lineStride = EINK().getFontHeight() + EINK().getLineSpacing();
+    for (size_t r = 0; r < frame.rows.size(); ++r) {
+      const int line = frame.rows[r].line;
+      if (frame.rows[r].pos != 0 || (line != frame.choice && line != frame.drawnChoice)) continue;
+      area.add(box.x, box.y + (int)(r - 1) * lineStride, box.w, 3 * lineStride);
+    }
+    // keep it inside the frame
+    if (!area.empty()) {
+      const int16_t top    = max(area.y, box.y);
+      const int16_t bottom = min<int16_t>(area.y + area.h, box.y + box.h);
+      area.y = top;
+      area.h = bottom - top;
+    }
+  }
+  return area;
+}
+// DRAW ONE FRAME !!
+static void drawFrame(Frame& frame) {
+  const EinkRect box = frameBox(frame);
 
-        const bool right  = (lv.flags & LF_RIGHT)  != 0;
-        const bool center = (lv.flags & LF_CENTER) != 0;
+  // if frame overlaps or is inverted, fill box with proper color
+  if (frame.invert || frame.overlap) {
+    display.fillRect(box.x, box.y, box.w, box.h, frame.invert ? GxEPD_BLACK : GxEPD_WHITE);
+  }
 
-        const bool isSelectedLine = (frame == CurrentFrameState) && (frame->choice == line);
-        bool firstSlice = true;
+  if (frame.box) {
+    if (box.w > 2 && box.h > 2) {
+      drawFrameBox(box.x + 1, box.y + 1, box.w - 2, box.h - 2, frame.invert);
+    }
+  }
+  if (frame.bitmap) {
+    const uint16_t bitColor = frame.invert ? GxEPD_WHITE : GxEPD_BLACK;
+    if (frame.bitmapW <= box.w && frame.bitmapH <= box.h) {
+      int x = box.x + (box.w - frame.bitmapW) / 2;
+      int y = box.y + (box.h - frame.bitmapH) / 2;
+      display.drawBitmap(x, y, frame.bitmap, frame.bitmapW, frame.bitmapH, bitColor);
+    }
+    return;
+  }
 
-        size_t pos = 0;
-        while (pos < effLen) {
-          size_t take = sliceThatFits(lv.ptr + pos, effLen - pos, maxTextWidth);
-          if (take == 0) break;
+  for (size_t r = 0; r < frame.rows.size(); ++r) {
+    const Frame::Row& row = frame.rows[r];
+    if (row.len == 0) continue;
 
-          String toPrint;
-          if (right)       toPrint = "~R~";
-          else if (center) toPrint = "~C~";
+    LineView lv = frame.source->line(row.line);
+    const bool right  = (lv.flags & LF_RIGHT)  != 0;
+    const bool center = (lv.flags & LF_CENTER) != 0;
 
+    String toPrint;
+    if (right)       toPrint = "~R~";
+    else if (center) toPrint = "~C~";
+    toPrint.concat(lv.ptr + row.pos, row.len);
 
+    const bool isSelectedLine = (&frame == CurrentFrameState) && (frame.choice == row.line);
+    if (isSelectedLine && row.pos == 0) {
+      toPrint.concat('<');
+    }
+    drawLineInFrame(toPrint, (int)r, frame, 0, false, true);
+  }
+}
+// DRAW THE FRAMES THAT CHANGED SINCE THE LAST CALL, IN ONE PARTIAL WINDOW AROUND THE CHANGES -- NOTE: remove ~C~ and ~R~ with switch to lineview flags
+void einkFramesDynamic(std::vector<Frame*> &frames, bool doFull_) {
+  if (frames.empty()) return;
 
-          toPrint.concat(String(lv.ptr + pos).substring(0, take));
+  EINK().setTXTFont(EINK().getCurrentFont());
 
-          if (isSelectedLine && firstSlice) {
-            toPrint = toPrint + "<";
-          }
-          // draw with the current visual row index
-          drawLineInFrame(toPrint, outLine++, *frame, 0, false,!doFull_);
+  // lay out every frame first; scroll and choice clamping can change what needs drawing
+  EinkRect window;
+  EinkRect covered;
+  for (Frame* frame : frames) {
+    if (!frame) continue;
+    const EinkRect box = frameBox(*frame);
+    if (box.empty()) continue;
+    layoutFrame(*frame);
+    window.merge(doFull_ ? box : changedArea(*frame));
+    covered.merge(box);
+  }
+  if (window.empty()) return;
+
+  // y & h must be divisible by 8 for GxEPD2 with rotation == 3
+  const int frameX = max<int>(0, window.x);
+  const int frameY = max(0, alignDown8(window.y));
+  const int frameW = min<int>(display.width(), window.x + window.w) - frameX;
+  const int frameH = min<int>(display.height(), alignUp8(window.y + window.h)) - frameY;
+  window = { (int16_t)frameX, (int16_t)frameY, (int16_t)frameW, (int16_t)frameH };
+  covered.merge(window);
+
+  // The display buffer keeps every frame in screen coordinates, only the window goes to the
+  // panel. A paged partial window would white out the rest of the buffer, and the next
+  // refresh(), which sends the whole buffer after a write it can't track, would wipe the
+  // frames outside the window off the panel.
+  EINK().waitForRefresh();
+  display.setFullWindow();
+  display.fillRect(covered.x, covered.y, covered.w, covered.h, GxEPD_WHITE);
+  // every frame is repainted, in order, so overlapping frames stay stacked
+  for (Frame* frame : frames) {
+    if (!frame || (!frame->source && !frame->bitmap)) continue;
+    if (frameBox(*frame).empty()) continue;
+    drawFrame(*frame);
+  }
+  display.displayWindow(frameX, frameY, frameW, frameH);
 
-          pos += take;
-          firstSlice = false;
-        }
-      }
-   
-      }
-    //Serial.println("Stopped Drawing Text!");
-  } while (display.nextPage());
-    //Serial.println("Done drawing frames!");
+  for (Frame* frame : frames) {
+    if (!frame) continue;
+    frame->dirty        = false;
+    frame->drawnBitmap  = frame->bitmap;
+    frame->drawnChoice  = frame->choice;
+    frame->drawnCurrent = (frame == CurrentFrameState);
+    frame->drawnLeft    = frame->left;
+    frame->drawnRight   = frame->right;
+    frame->drawnTop     = frame->top;
+    frame->drawnBottom  = frame->bottom;
+  }
 }
 // DRAW BOX AROUND FRAME !!
 void drawFrameBox(int usableX, int usableY, int usableWidth, int usableHeight,bool invert) {
@@ -546,7 +690,7 @@ void oledScrollFrame() {
     u8g2.drawStr(0, 24, lineNumStr.c_str());
   }
   // send buffer
-  u8g2.sendBuffer();
+  OLED().sendBuffer();
 }
 
 ///////////////////////////// TEXT POSITION FUNCTIONS
@@ -0,0 +1,130 @@
+#include <pocketmage.h>
+
+static constexpr const char* tag = "SPRITE";
+
+// XBM rows are LSB first: pixel i is bit i % 8 of byte i / 8
+static void mirrorRow(const uint8_t* src, uint8_t* dst, uint8_t width, uint8_t rowBytes) {
+  memset(dst, 0, rowBytes);
+  for (uint8_t i = 0; i < width; i++) {
+    if (src[i >> 3] & (1 << (i & 7))) {
+      const uint8_t j = width - 1 - i;
+      dst[j >> 3] |= 1 << (j & 7);
+    }
+  }
+}
+
+// ===================== SPRITE ATLAS =====================
+int SpriteAtlas::addClip(const unsigned char* const* frames, uint8_t count, uint8_t w, uint8_t h) {
+  if (h > 32 || count == 0) {
+    ESP_LOGE(tag, "Clip of %u frames %ux%u not supported", count, w, h);
+    return -1;
+  }
+
+  Clip c;
+  c.width    = w;
+  c.height   = h;
+  c.rowBytes = (w + 7) / 8;
+  c.count    = count;
+
+  const size_t frameBytes = (size_t)c.rowBytes * h;
+  c.first[0].assign(frames[0], frames[0] + frameBytes);
+  c.first[1].resize(frameBytes);
+  for (uint8_t r = 0; r < h; r++) {
+    mirrorRow(&c.first[0][r * c.rowBytes], &c.first[1][r * c.rowBytes], w, c.rowBytes);
+  }
+
+  // Frame 0 is diffed against the last frame so a looping clip never needs a full redraw
+  c.changed.resize(count);
+  c.offset.resize(count);
+  uint16_t rows = 0;
+  for (uint8_t f = 0; f < count; f++) {
+    const uint8_t* prev = frames[f ? f - 1 : count - 1];
+    const uint8_t* cur  = frames[f];
+    uint32_t       mask = 0;
+    c.offset[f]         = rows;
+    for (uint8_t r = 0; r < h; r++) {
+      const uint8_t* row = cur + r * c.rowBytes;
+      if (memcmp(row, prev + r * c.rowBytes, c.rowBytes) == 0) continue;
+      mask |= 1UL << r;
+      c.rows[0].insert(c.rows[0].end(), row, row + c.rowBytes);
+      c.rows[1].resize(c.rows[1].size() + c.rowBytes);
+      mirrorRow(row, &c.rows[1][c.rows[1].size() - c.rowBytes], w, c.rowBytes);
+      rows++;
+    }
+    c.changed[f] = mask;
+  }
+
+  ESP_LOGD(tag, "Clip %u: %u frames, %u of %u rows stored", (unsigned)clips_.size(), count,
+           rows, (unsigned)count * h);
+  clips_.push_back(std::move(c));
+  return clips_.size() - 1;
+}
+
+// ===================== OLED SPRITE =====================
+uint32_t OledSprite::draw(U8G2& u8, int clip, uint8_t frame, bool flip, int16_t x, int16_t y) {
+  const SpriteAtlas::Clip& c = atlas_.clips_[clip];
+  frame %= c.count;
+
+  const bool sameSpot = shown_ && clip == clip_ && flip == flip_ && x == x_ && y == y_;
+  if (sameSpot && frame == frame_) return 0;
+
+  u8.setBitmapMode(1);
+  if (sameSpot && frame == (frame_ + 1) % c.count) {
+    // Stepping in place: only the rows this frame changes
+    const uint32_t rows = c.changed[frame];
+    blit_(u8, rows, 0);
+    apply_(c, frame, flip);
+    blit_(u8, rows, 1);
+    frame_ = frame;
+    return rows;
+  }
+
+  if (shown_) blit_(u8, UINT32_MAX, 0);
+  seek_(c, frame, flip);
+  clip_  = clip;
+  frame_ = frame;
+  flip_  = flip;
+  x_     = x;
+  y_     = y;
+  shown_ = true;
+  blit_(u8, UINT32_MAX, 1);
+  return UINT32_MAX;
+}
+
+void OledSprite::redraw(U8G2& u8) {
+  if (!shown_) return;
+  u8.setBitmapMode(1);
+  blit_(u8, UINT32_MAX, 1);
+}
+
+// Rebuilds bitmap_ as frame, starting from the frame on hand when that is on the way
+void OledSprite::seek_(const SpriteAtlas::Clip& c, uint8_t frame, bool flip) {
+  uint8_t from = 1;
+  if (!shown_ || &c != &atlas_.clips_[clip_] || flip != flip_ || frame < frame_) {
+    bitmap_ = c.first[flip];
+  } else {
+    from = frame_ + 1;
+  }
+  for (uint8_t f = from; f <= frame; f++) apply_(c, f, flip);
+}
+
+// Writes frame's changed rows into bitmap_, which must hold the frame before it
+void OledSprite::apply_(const SpriteAtlas::Clip& c, uint8_t frame, bool flip) {
+  const uint8_t* src  = c.rows[flip].data() + c.offset[frame] * c.rowBytes;
+  uint32_t       rows = c.changed[frame];
+  for (uint8_t r = 0; rows; r++, rows >>= 1) {
+    if (!(rows & 1)) continue;
+    memcpy(&bitmap_[r * c.rowBytes], src, c.rowBytes);
+    src += c.rowBytes;
+  }
+}
+
+// Draws the set pixels of the given rows of bitmap_ in color; 0 erases them
+void OledSprite::blit_(U8G2& u8, uint32_t rows, uint8_t color) {
+  const SpriteAtlas::Clip& c = atlas_.clips_[clip_];
+  u8.setDrawColor(color);
+  for (uint8_t r = 0; r < c.height && rows; r++, rows >>= 1) {
+    if (rows & 1) u8.drawXBMP(x_, y_ + r, c.width, 1, &bitmap_[r * c.rowBytes]);
+  }
+  u8.setDrawColor(1);
+}
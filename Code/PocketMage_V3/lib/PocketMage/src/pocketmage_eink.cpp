@@ -10,9 +10,11 @@
 
 static constexpr const char* tag = "EINK";
 
-GxEPD2_BW<GxEPD2_310_GDEQ031T10, GxEPD2_310_GDEQ031T10::HEIGHT> display(GxEPD2_310_GDEQ031T10(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY));
+PocketmageDisplay display(GxEPD2_310_GDEQ031T10(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY));
 
 TaskHandle_t einkHandlerTaskHandle = NULL; // E-Ink handler task
+static TaskHandle_t einkRefreshTaskHandle = NULL; // Sends presented frames to the panel
+static SemaphoreHandle_t epdBusyEdge = NULL;      // Given on every EPD_BUSY edge
 
 // Fast full update flag for e-ink
 volatile bool GxEPD2_310_GDEQ031T10::useFastFullUpdate = true;
@@ -23,27 +25,428 @@ static PocketmageEink pm_eink(display);
 // Access for other apps 
 PocketmageEink& EINK() { return pm_eink; }
 
+// ===================== dirty tracking =====================
+void EinkRect::add(int16_t px, int16_t py, int16_t pw, int16_t ph) {
+  if (empty()) {
+    x = px; y = py; w = pw; h = ph;
+    return;
+  }
+  const int16_t right  = max<int16_t>(x + w, px + pw);
+  const int16_t bottom = max<int16_t>(y + h, py + ph);
+  x = min(x, px);
+  y = min(y, py);
+  w = right - x;
+  h = bottom - y;
+}
+// Grow to whole bytes of the panel buffer in both directions
+void EinkRect::alignToBytes() {
+  if (empty()) return;
+  const int16_t right  = (x + w + 7) & ~7;
+  const int16_t bottom = (y + h + 7) & ~7;
+  x &= ~7;
+  y &= ~7;
+  w = right - x;
+  h = bottom - y;
+}
+EinkRect EinkRect::toPanel(uint8_t rotation) const {
+  if (empty()) return EinkRect();
+  // Mirrors the coordinate swaps in GxEPD2_BW::drawPixel
+  switch (rotation & 3) {
+    case 1:  return {(int16_t)(PanelT::WIDTH - y - h), x, h, w};
+    case 2:  return {(int16_t)(PanelT::WIDTH - x - w), (int16_t)(PanelT::HEIGHT - y - h), w, h};
+    case 3:  return {y, (int16_t)(PanelT::HEIGHT - x - w), h, w};
+    default: return *this;
+  }
+}
+
+void PocketmageDisplay::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  GxEPD2_BW::drawPixel(x, y, color);
+  if (x < 0 || y < 0 || x >= width() || y >= height()) return;
+
+  if (dirty_.empty()) {
+    dirty_ = {x, y, 1, 1};
+  } else {
+    if (x < dirty_.x) { dirty_.w += dirty_.x - x; dirty_.x = x; }
+    else if (x >= dirty_.x + dirty_.w) dirty_.w = x - dirty_.x + 1;
+    if (y < dirty_.y) { dirty_.h += dirty_.y - y; dirty_.y = y; }
+    else if (y >= dirty_.y + dirty_.h) dirty_.h = y - dirty_.y + 1;
+  }
+}
+void PocketmageDisplay::fillScreen(uint16_t color) {
+  GxEPD2_BW::fillScreen(color);
+  // A white buffer has nothing drawn on it
+  if (color == GxEPD_WHITE && !partialWindow_) clearDirty();
+  else if (color != GxEPD_WHITE) dirty_ = {0, 0, width(), height()};
+}
+void PocketmageDisplay::setFullWindow() {
+  GxEPD2_BW::setFullWindow();
+  partialWindow_ = false;
+}
+void PocketmageDisplay::setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  GxEPD2_BW::setPartialWindow(x, y, w, h);
+  partialWindow_ = true;
+}
+void PocketmageDisplay::display(bool partial_update_mode) {
+  panelWrites_++;
+  GxEPD2_BW::display(partial_update_mode);
+}
+void PocketmageDisplay::displayWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+  panelWrites_++;
+  GxEPD2_BW::displayWindow(x, y, w, h);
+}
+bool PocketmageDisplay::nextPage() {
+  panelWrites_++;
+  return GxEPD2_BW::nextPage();
+}
+
+// ===================== busy line =====================
+static void IRAM_ATTR EPD_BUSY_irq() {
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(epdBusyEdge, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// GxEPD2 calls this while the panel reports busy; block until the pin changes instead of
+// spinning, so other tasks on core 0 keep running through a refresh
+static void waitForBusyEdge(const void*) {
+  xSemaphoreTake(epdBusyEdge, pdMS_TO_TICKS(20));
+}
+
+// ===================== ghosting =====================
+// Each tile collects points for the partial updates and pixel flips it has been through; once
+// one runs over budget that part of the panel gets a clean-up instead of the whole screen
+// flashing after a fixed number of updates
+EinkRect PocketmageEink::toTiles_(const EinkRect& area) const {
+  if (area.empty()) return EinkRect();
+  const int16_t c0 = max(0, area.x / EINK_GHOST_TILE);
+  const int16_t r0 = max(0, area.y / EINK_GHOST_TILE);
+  const int16_t c1 = min<int16_t>(GHOST_COLS - 1, (area.x + area.w - 1) / EINK_GHOST_TILE);
+  const int16_t r1 = min<int16_t>(GHOST_ROWS - 1, (area.y + area.h - 1) / EINK_GHOST_TILE);
+  return {c0, r0, (int16_t)(c1 - c0 + 1), (int16_t)(r1 - r0 + 1)};
+}
+void PocketmageEink::addGhost_(const EinkRect& area, uint16_t points, const uint16_t* flips) {
+  const EinkRect tiles = toTiles_(area);
+  for (int16_t r = tiles.y; r < tiles.y + tiles.h; r++) {
+    for (int16_t c = tiles.x; c < tiles.x + tiles.w; c++) {
+      const uint8_t  i     = r * GHOST_COLS + c;
+      const uint32_t score = ghost_[i] + points + (flips ? flips[i] / EINK_GHOST_FLIP_PIXELS : 0);
+      ghost_[i] = min<uint32_t>(score, UINT16_MAX);
+    }
+  }
+}
+EinkRect PocketmageEink::ghostOverBudget_() const {
+  const uint16_t budget = (uint16_t)fullRefreshAfter_ * EINK_GHOST_BUDGET;
+  EinkRect over;
+  for (uint8_t i = 0; i < GHOST_TILES; i++) {
+    if (ghost_[i] < budget) continue;
+    over.add((i % GHOST_COLS) * EINK_GHOST_TILE, (i / GHOST_COLS) * EINK_GHOST_TILE,
+             EINK_GHOST_TILE, EINK_GHOST_TILE);
+  }
+  return over;
+}
+void PocketmageEink::resetGhost_(const EinkRect& area) {
+  const EinkRect tiles = toTiles_(area);
+  for (int16_t r = tiles.y; r < tiles.y + tiles.h; r++) {
+    for (int16_t c = tiles.x; c < tiles.x + tiles.w; c++) ghost_[r * GHOST_COLS + c] = 0;
+  }
+}
+
 // ===================== main functions =====================
 void PocketmageEink::refresh() {
-  // USE A SLOW FULL UPDATE EVERY N FAST UPDATES OR WHEN SPECIFIED
-  if ((partialCounter_ >= fullRefreshAfter_) || forceSlowFullUpdate_) {
+  waitForRefresh();
+
+  // Only pixels inside what is drawn now or what was drawn last time can differ from the panel.
+  // Paged or direct display() calls since then may have drawn anywhere.
+  if (onScreenWrites_ != display_.panelWrites()) onScreen_ = {0, 0, display_.width(), display_.height()};
+  EinkRect area = display_.dirty();
+  area.merge(onScreen_);
+  area.alignToBytes();
+  const bool large = (int32_t)area.w * area.h * 100 >
+                     (int32_t)EINK_PARTIAL_MAX_PERCENT * display_.width() * display_.height();
+  onScreen_ = display_.dirty();
+
+  // The display buffer can't be sent inverted for a local clean-up, so a tile over budget
+  // still means a slow full refresh on this path
+  if (!forceSlowFullUpdate_ && !large && !area.empty())
+    addGhost_(area.toPanel(display_.getRotation()), EINK_GHOST_UPDATE_POINTS);
+
+  if (forceSlowFullUpdate_ || large || !ghostOverBudget_().empty()) {
+    selectRefreshMode_();
+    display_.display(false);
+  } else if (!area.empty()) {
+    display_.displayWindow(area.x, area.y, area.w, area.h);
+  }
+  onScreenWrites_ = display_.panelWrites();
+
+  display_.setFullWindow();
+  display_.fillScreen(GxEPD_WHITE);
+  display_.hibernate();
+}
+// Full refresh from an off-screen canvas, the display buffer is left untouched
+void PocketmageEink::refresh(const EinkCanvas& canvas) {
+  waitForRefresh();
+  sendCanvas_(canvas);
+}
+// Writes panel rows [y, y + h) a band of EINK_SPI_BAND_ROWS at a time, each under its own bus
+// lease, so the OLED is never kept off the bus for a whole image. Refresh commands take no
+// lease: the panel only sits on BUSY then, and the bus is free.
+template <typename WriteBand>
+static void writeInBands(int16_t y, int16_t h, WriteBand writeBand) {
+  for (int16_t top = y; top < y + h; top += EINK_SPI_BAND_ROWS) {
+    SpiLease lease(SPI_DEVICE_EINK);
+    writeBand(top, min<int16_t>(EINK_SPI_BAND_ROWS, y + h - top));
+  }
+}
+
+void PocketmageEink::sendCanvas_(const EinkCanvas& canvas) {
+  const uint8_t* buffer = canvas.getBuffer();
+  if (!buffer) return;
+
+  if (!committed_) {
+    committed_ = new EinkCanvas();
+    if (!committed_->getBuffer()) {
+      delete committed_;
+      committed_ = nullptr;
+    }
+  }
+
+  // Compare against the last canvas sent, as long as nothing else has been shown since
+  const bool known   = committed_ && committedWrites_ == display_.panelWrites();
+  uint16_t   flips[GHOST_TILES] = {};
+  EinkRect   changed = known ? canvas.diff(*committed_, flips)
+                             : EinkRect{0, 0, PanelT::WIDTH, PanelT::HEIGHT};
+  if (known && !forceSlowFullUpdate_ && changed.empty()) return;  // Identical frame, leave the panel alone
+
+  const bool large = (int32_t)changed.w * changed.h * 100 >
+                     (int32_t)EINK_PARTIAL_MAX_PERCENT * PanelT::WIDTH * PanelT::HEIGHT;
+  onScreen_ = {0, 0, display_.width(), display_.height()};
+
+  if (!known || forceSlowFullUpdate_ || large) {
+    // Same sequence as GxEPD2_BW::display(false), fed from the canvas
+    selectRefreshMode_();
+    writeInBands(0, PanelT::HEIGHT, [&](int16_t y, int16_t h) {
+      display_.epd2.writeImageForFullRefresh(buffer + y * (PanelT::WIDTH / 8), 0, y,
+                                             PanelT::WIDTH, h);
+    });
+    display_.epd2.refresh(false);
+    if (PanelT::hasFastPartialUpdate) {
+      writeInBands(0, PanelT::HEIGHT, [&](int16_t y, int16_t h) {
+        display_.epd2.writeImageAgain(buffer + y * (PanelT::WIDTH / 8), 0, y, PanelT::WIDTH, h);
+      });
+    }
+  } else {
+    addGhost_(changed, EINK_GHOST_UPDATE_POINTS, flips);
+    EinkRect area = ghostOverBudget_();
+    if (!area.empty()) {
+      // Clean up the worn tiles along with this update: drive them through the inverted
+      // image first, so every pixel in the area makes a full transition
+      area.merge(changed);
+      const EinkRect tiles = toTiles_(area);
+      area = {(int16_t)(tiles.x * EINK_GHOST_TILE), (int16_t)(tiles.y * EINK_GHOST_TILE),
+              (int16_t)min<int16_t>(tiles.w * EINK_GHOST_TILE, PanelT::WIDTH - tiles.x * EINK_GHOST_TILE),
+              (int16_t)min<int16_t>(tiles.h * EINK_GHOST_TILE, PanelT::HEIGHT - tiles.y * EINK_GHOST_TILE)};
+      writeInBands(area.y, area.h, [&](int16_t y, int16_t h) {
+        display_.epd2.writeImagePart(buffer, area.x, y, PanelT::WIDTH, PanelT::HEIGHT,
+                                     area.x, y, area.w, h, true);
+      });
+      display_.epd2.refresh(area.x, area.y, area.w, area.h);
+      resetGhost_(area);
+    } else {
+      area = changed;
+    }
+
+    // Partial update of the changed rows only, panel coordinates
+    writeInBands(area.y, area.h, [&](int16_t y, int16_t h) {
+      display_.epd2.writeImagePart(buffer, area.x, y, PanelT::WIDTH, PanelT::HEIGHT,
+                                   area.x, y, area.w, h);
+    });
+    display_.epd2.refresh(area.x, area.y, area.w, area.h);
+    writeInBands(area.y, area.h, [&](int16_t y, int16_t h) {
+      display_.epd2.writeImagePartAgain(buffer, area.x, y, PanelT::WIDTH, PanelT::HEIGHT,
+                                        area.x, y, area.w, h);
+    });
+  }
+
+  if (committed_) {
+    committed_->copyFrom(canvas);
+    committedWrites_ = display_.panelWrites();
+  }
+  display_.hibernate();
+}
+EinkCanvas* PocketmageEink::beginFrame() {
+  if (!back_) {
+    front_ = new EinkCanvas();
+    back_  = new EinkCanvas();
+    if (!front_->getBuffer() || !back_->getBuffer()) {
+      ESP_LOGE(tag, "No memory for frame buffers");
+      delete front_;
+      delete back_;
+      front_ = back_ = nullptr;
+      return nullptr;
+    }
+  }
+  return back_;
+}
+void PocketmageEink::present(RefreshDone done) {
+  if (!back_) return;
+  // No refresh task yet, send it in place
+  if (!einkRefreshTaskHandle) {
+    refresh(*back_);
+    if (done) done();
+    return;
+  }
+
+  // The previous frame must be off the front buffer before it can be reused
+  xSemaphoreTake(idle_, portMAX_DELAY);
+  std::swap(front_, back_);
+  done_ = done;
+  xTaskNotifyGive(einkRefreshTaskHandle);
+}
+bool PocketmageEink::refreshBusy() { return idle_ && uxSemaphoreGetCount(idle_) == 0; }
+void PocketmageEink::waitForRefresh() {
+  if (!idle_ || xTaskGetCurrentTaskHandle() == einkRefreshTaskHandle) return;
+  xSemaphoreTake(idle_, portMAX_DELAY);
+  xSemaphoreGive(idle_);
+}
+void PocketmageEink::startRefreshTask_() {
+  listLock_  = xSemaphoreCreateMutex();
+  listsDone_ = xSemaphoreCreateBinary();
+  idle_ = xSemaphoreCreateBinary();
+  xSemaphoreGive(idle_);
+  xTaskCreatePinnedToCore(
+    refreshTask_,            // Function name
+    "einkRefreshTask",       // Task name
+    4096,                    // Stack size
+    NULL,                    // Parameters
+    2,                       // Priority, above einkHandler so BUSY edges are handled promptly
+    &einkRefreshTaskHandle,  // Task handle
+    0                        // Core ID
+  );
+}
+void PocketmageEink::refreshTask_(void* parameter) {
+  PocketmageEink& eink = EINK();
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    eink.sendCanvas_(*eink.front_);
+
+    RefreshDone done = std::move(eink.done_);
+    eink.done_ = nullptr;
+    xSemaphoreGive(eink.idle_);
+    if (done) done();
+  }
+}
+void PocketmageEink::requestRedraw(RedrawPriority priority) {
+  if (priority == REDRAW_IDLE) {
+    if (!idleRedrawAt_) {
+      const ulong at = millis() + EINK_IDLE_REDRAW_MS;
+      idleRedrawAt_ = at ? at : 1;
+    }
+  } else {
+    if (priority == REDRAW_NOW) redrawNow_ = true;
+    redrawPending_ = true;
+  }
+  // Also wakes a waiting task so it picks up a new idle deadline
+  if (einkHandlerTaskHandle) xTaskNotifyGive(einkHandlerTaskHandle);
+}
+void PocketmageEink::waitForRedraw() {
+  for (;;) {
+    if (redrawPending_) break;
+
+    TickType_t timeout = portMAX_DELAY;
+    if (idleRedrawAt_) {
+      const long left = (long)(idleRedrawAt_ - millis());
+      if (left <= 0) {
+        idleRedrawAt_ = 0;
+        return;
+      }
+      timeout = pdMS_TO_TICKS(left);
+    }
+    ulTaskNotifyTake(pdTRUE, timeout);
+  }
+
+  // Let a burst of keypresses settle so it costs one pass, without holding off for long
+  for (uint8_t i = 0; i < 4 && !redrawNow_; i++) {
+    if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(EINK_COALESCE_MS))) break;
+  }
+  redrawPending_ = false;
+  redrawNow_     = false;
+}
+// ===================== display lists =====================
+void PocketmageEink::submit(EinkDisplayList&& list) {
+  if (list.empty()) return;
+  // No e-ink task to hand it to, draw it in place
+  if (!einkHandlerTaskHandle || !listLock_ ||
+      xTaskGetCurrentTaskHandle() == einkHandlerTaskHandle) {
+    display_.setFullWindow();
+    list.replay(display_);
+    if (list.getCommit() == COMMIT_SLOW_FULL) forceSlowFullUpdate_ = true;
+    if (list.getCommit() != COMMIT_NONE) refresh();
+    return;
+  }
+
+  xSemaphoreTake(listLock_, portMAX_DELAY);
+  lists_.push_back(std::move(list));
+  listsSubmitted_++;
+  xSemaphoreGive(listLock_);
+  requestRedraw(REDRAW_NOW);
+}
+void PocketmageEink::replayDisplayLists() {
+  if (!listLock_) return;
+  std::vector<EinkDisplayList> lists;
+  xSemaphoreTake(listLock_, portMAX_DELAY);
+  lists.swap(lists_);
+  xSemaphoreGive(listLock_);
+
+  for (const EinkDisplayList& list : lists) {
+    display_.setFullWindow();
+    list.replay(display_);
+    if (list.getCommit() == COMMIT_SLOW_FULL) forceSlowFullUpdate_ = true;
+    if (list.getCommit() != COMMIT_NONE) refresh();
+  }
+  if (lists.empty()) return;
+
+  xSemaphoreTake(listLock_, portMAX_DELAY);
+  listsReplayed_ += lists.size();
+  xSemaphoreGive(listLock_);
+  xSemaphoreGive(listsDone_);
+}
+void PocketmageEink::waitForDisplayLists() {
+  if (xTaskGetCurrentTaskHandle() == einkHandlerTaskHandle) {
+    replayDisplayLists();
+    return;
+  }
+  if (!einkHandlerTaskHandle || !listLock_) return;
+
+  xSemaphoreTake(listLock_, portMAX_DELAY);
+  const uint32_t target = listsSubmitted_;
+  xSemaphoreGive(listLock_);
+  for (;;) {
+    xSemaphoreTake(listLock_, portMAX_DELAY);
+    const bool replayed = (int32_t)(listsReplayed_ - target) >= 0;
+    xSemaphoreGive(listLock_);
+    if (replayed) break;
+    xSemaphoreTake(listsDone_, portMAX_DELAY);
+  }
+  // Pass the wake-up on in case another task is waiting on an earlier batch
+  xSemaphoreGive(listsDone_);
+}
+
+void PocketmageEink::selectRefreshMode_() {
+  // USE A SLOW FULL UPDATE WHEN ANY TILE IS OVER ITS GHOST BUDGET OR WHEN SPECIFIED
+  if (!ghostOverBudget_().empty() || forceSlowFullUpdate_) {
     forceSlowFullUpdate_ = false;
-    partialCounter_ = 0;
+    memset(ghost_, 0, sizeof(ghost_));
     setFastFullRefresh(false);
   } 
-  // OTHERWISE USE A FAST FULL UPDATE
+  // OTHERWISE USE A FAST FULL UPDATE, WHICH COUNTS AS A WHOLE STEP EVERYWHERE
   else {
     setFastFullRefresh(true);
-    partialCounter_++;
+    addGhost_({0, 0, PanelT::WIDTH, PanelT::HEIGHT}, EINK_GHOST_BUDGET);
   }
-
-  display_.display(false);
-
-  display_.setFullWindow();
-  display_.fillScreen(GxEPD_WHITE);
-  display_.hibernate();
 }
 void PocketmageEink::multiPassRefresh(int passes) {
+  waitForRefresh();
+  onScreen_ = display_.dirty();
   display_.display(false);
   if (passes > 0) {
     for (int i = 0; i < passes; i++) {
@@ -51,6 +454,7 @@ void PocketmageEink::multiPassRefresh(int passes) {
       display_.display(true);
     }
   }
+  onScreenWrites_ = display_.panelWrites();
 
   delay(100);
   display_.setFullWindow();
@@ -178,6 +582,13 @@ void setupEink() {
   display.setTextColor(GxEPD_BLACK);
   EINK().setTXTFont(&FreeMonoBold9pt7b); // default font, computeFontMetrics_()
 
+  // Sleep on the BUSY line during refreshes instead of polling it
+  epdBusyEdge = xSemaphoreCreateBinary();
+  attachInterrupt(digitalPinToInterrupt(EPD_BUSY), EPD_BUSY_irq, CHANGE);
+  display.epd2.setBusyCallback(waitForBusyEdge);
+
+  EINK().startRefreshTask_();
+
   xTaskCreatePinnedToCore(
     einkHandler,             // Function name
     "einkHandlerTask",       // Task name
@@ -13,16 +13,50 @@ static constexpr const char* tag = "OLED";
 // Initialization of oled display class
 static PocketmageOled pm_oled(u8g2);
 
+static TaskHandle_t oledCompositorTaskHandle = NULL;   // The only task that talks to the panel
+
+// oledWord() tries these largest first; the first is only used with allowLarge
+static const uint8_t* const WORD_FONTS[]    = {u8g2_font_ncenB18_tr, u8g2_font_ncenB14_tr,
+                                               u8g2_font_ncenB12_tr, u8g2_font_ncenB10_tr,
+                                               u8g2_font_ncenB08_tr};
+static const uint8_t        WORD_BASELINE[] = {16 + 5, 16 + 3, 16 + 2, 16 + 1, 16};
+static constexpr uint8_t    WORD_FONT_COUNT = sizeof(WORD_BASELINE);
+
+static const uint8_t* const LINE_FONT = u8g2_font_ncenB18_tr;   // oledLine() text
+
+// u8g2's full buffer: tile rows of tileWidth * 8 bytes, each tile 8 bytes of vertical pixel columns
+static size_t frameBytes(U8G2& u8) {
+  return (size_t)u8.getBufferTileWidth() * u8.getBufferTileHeight() * 8;
+}
+
+// Lock held for the rest of the scope; a no-op before the compositor is started
+class OledLock {
+public:
+  explicit OledLock(SemaphoreHandle_t lock) : lock_(lock) {
+    if (lock_) xSemaphoreTake(lock_, portMAX_DELAY);
+  }
+  ~OledLock() {
+    if (lock_) xSemaphoreGive(lock_);
+  }
+
+private:
+  SemaphoreHandle_t lock_;
+};
+
 // 256x32 SPI OLED display object
 U8G2_SSD1326_ER_256X32_F_4W_HW_SPI u8g2(U8G2_R2, OLED_CS, OLED_DC, OLED_RST);
 
 // Setup for Oled Class
 void setupOled() {
-  u8g2.begin();
-  u8g2.setBusClock(10000000);
-  u8g2.setPowerSave(0);
-  u8g2.clearBuffer();
-  u8g2.sendBuffer();
+  {
+    SpiLease lease(SPI_DEVICE_OLED);
+    u8g2.begin();
+    u8g2.setBusClock(10000000);
+    u8g2.setPowerSave(0);
+    u8g2.clearBuffer();
+    u8g2.sendBuffer();
+  }
+  pm_oled.startCompositorTask_();
 }
 
 // oled object reference for other apps
@@ -30,57 +64,24 @@ PocketmageOled& OLED() { return pm_oled; }
 
 // ===================== public functions =====================
 void PocketmageOled::oledWord(String word, bool allowLarge, bool showInfo) {
-  u8g2_.clearBuffer();
-
-  if (showInfo) infoBar();
-
-  if (allowLarge) {
-    /*u8g2_.setFont(u8g2_font_ncenB24_tr);
-    if (u8g2_.getStrWidth(word.c_str()) < u8g2_.getDisplayWidth()) {
-      u8g2_.drawStr((u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()))/2,16+12,word.c_str());
-      u8g2_.sendBuffer();
-      return;
-    }*/
-    u8g2_.setFont(u8g2_font_ncenB18_tr);
-    if (u8g2_.getStrWidth(word.c_str()) < u8g2_.getDisplayWidth()) {
-      u8g2_.drawStr((u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()))/2,16+5,word.c_str());
-      u8g2_.sendBuffer();
-      return;
-    }
-  }
-
-  u8g2_.setFont(u8g2_font_ncenB14_tr);
-  if (u8g2_.getStrWidth(word.c_str()) < u8g2_.getDisplayWidth()) {
-    u8g2_.drawStr((u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()))/2,16+3,word.c_str());
-    u8g2_.sendBuffer();
-    return;
-  }
+  drawWord_(word, allowLarge, showInfo);
+  sendBuffer();
+}
 
-  u8g2_.setFont(u8g2_font_ncenB12_tr);
-  if (u8g2_.getStrWidth(word.c_str()) < u8g2_.getDisplayWidth()) {
-    u8g2_.drawStr((u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()))/2,16+2,word.c_str());
-    u8g2_.sendBuffer();
-    return;
-  }
+void PocketmageOled::toast(const String& msg, uint16_t ms) {
+  // Leave whatever the caller has drawn so far in place for its own sendBuffer()
+  const uint8_t* buffer = u8g2_.getBufferPtr();
+  std::vector<uint8_t> saved(buffer, buffer + frameBytes(u8g2_));
 
-  u8g2_.setFont(u8g2_font_ncenB10_tr);
-  if (u8g2_.getStrWidth(word.c_str()) < u8g2_.getDisplayWidth()) {
-    u8g2_.drawStr((u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()))/2,16+1,word.c_str());
-    u8g2_.sendBuffer();
-    return;
+  drawWord_(msg, false, true);
+  {
+    OledLock lock(lock_);
+    toastUntil_ = millis() + (ms ? ms : OLED_TOAST_MS);
+    if (!toastUntil_) toastUntil_ = 1;
   }
+  commit_(LAYER_TOAST);
 
-  u8g2_.setFont(u8g2_font_ncenB08_tr);
-  if (u8g2_.getStrWidth(word.c_str()) < u8g2_.getDisplayWidth()) {
-    u8g2_.drawStr((u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()))/2,16,word.c_str());
-    u8g2_.sendBuffer();
-    return;
-  } else {
-    u8g2_.drawStr(u8g2_.getDisplayWidth() - u8g2_.getStrWidth(word.c_str()),16,word.c_str());
-    u8g2_.sendBuffer();
-    return;
-  }
-  
+  memcpy(u8g2_.getBufferPtr(), saved.data(), saved.size());
 }
 
 void PocketmageOled::oledLine(String line, bool doProgressBar, String bottomMsg) {
@@ -88,11 +89,13 @@ void PocketmageOled::oledLine(String line, bool doProgressBar, String bottomMsg)
     uint8_t maxLength = mcl;
     u8g2_.clearBuffer();
 
+  trackLine_(line);
+
   //PROGRESS BAR
   if (doProgressBar && line.length() > 0) {
     //uint8_t progress = map(line.length(), 0, maxLength, 0, 128);
 
-    const uint16_t charWidth = strWidth(line);
+    const uint16_t charWidth = line_.einkAdvance;
 
     const uint8_t progress = map(charWidth, 0, display.width()-5, 0, u8g2_.getDisplayWidth());
 
@@ -143,15 +146,16 @@ void PocketmageOled::oledLine(String line, bool doProgressBar, String bottomMsg)
   }
 
   // DRAW LINE TEXT (unchanged)
-  u8g2_.setFont(u8g2_font_ncenB18_tr);
-  if (u8g2_.getStrWidth(line.c_str()) < (u8g2_.getDisplayWidth() - 5)) {
+  u8g2_.setFont(LINE_FONT);
+  const uint16_t lineWidth = lineWidthOled_();
+  if (lineWidth < (u8g2_.getDisplayWidth() - 5)) {
     u8g2_.drawStr(0, 20, line.c_str());
-    if (line.length() > 0) u8g2_.drawVLine(u8g2_.getStrWidth(line.c_str()) + 2, 1, 22);
+    if (line.length() > 0) u8g2_.drawVLine(lineWidth + 2, 1, 22);
   } else {
-    u8g2_.drawStr(u8g2_.getDisplayWidth()-8-u8g2_.getStrWidth(line.c_str()), 20, line.c_str());
+    u8g2_.drawStr(u8g2_.getDisplayWidth()-8-lineWidth, 20, line.c_str());
   }
 
-  u8g2_.sendBuffer();
+  sendBuffer();
 }
 
 void PocketmageOled::infoBar() {
@@ -274,15 +278,246 @@ void PocketmageOled::oledScroll() {
   }
 
   // SEND BUFFER 
-  u8g2_.sendBuffer();
+  sendBuffer();
+}
+
+void PocketmageOled::sendBuffer() {
+  commit_(LAYER_APP);
+}
+
+void PocketmageOled::invalidate() {
+  {
+    OledLock lock(lock_);
+    fullPush_ = true;
+  }
+  if (oledCompositorTaskHandle) xTaskNotifyGive(oledCompositorTaskHandle);
 }
 
 void PocketmageOled::setPowerSave(bool enable) {
   OLEDPowerSave_ = enable;
+  OledLock bus(bus_);
+  SpiLease lease(SPI_DEVICE_OLED);
   u8g2_.setPowerSave(enable ? 1 : 0);
 }
+
+void PocketmageOled::setContrast(uint8_t contrast) {
+  OledLock bus(bus_);
+  SpiLease lease(SPI_DEVICE_OLED);
+  u8g2_.setContrast(contrast);
+}
+
+void PocketmageOled::startCompositorTask_() {
+  const size_t   size   = frameBytes(u8g2_);
+  const uint8_t* buffer = u8g2_.getBufferPtr();
+  for (auto& layer : layers_) layer.assign(buffer, buffer + size);
+  front_.assign(size, 0);
+  shadow_.assign(buffer, buffer + size);   // setupOled() has just sent it
+  fullPush_ = false;
+
+  lock_ = xSemaphoreCreateMutex();
+  bus_  = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(
+    compositorTask_,            // Function name
+    "oledCompositorTask",       // Task name
+    4096,                       // Stack size
+    NULL,                       // Parameters
+    2,                          // Priority, above einkHandler so frames keep their pace
+    &oledCompositorTaskHandle,  // Task handle
+    0                           // Core ID
+  );
+}
+
 // ===================== private functions =====================
 // COMPUTE STRING WIDTH IN EINK PIXELS
 uint16_t PocketmageOled::strWidth(const String& s) const {
   return EINK().getEinkTextWidth(s);
 }
+
+void PocketmageOled::drawWord_(const String& word, bool allowLarge, bool showInfo) {
+  u8g2_.clearBuffer();
+
+  if (showInfo) infoBar();
+
+  const WordFit fit = fitWord_(word, allowLarge);
+  const int     x   = fit.fits ? (u8g2_.getDisplayWidth() - fit.width) / 2
+                               : u8g2_.getDisplayWidth() - fit.width;
+  u8g2_.setFont(WORD_FONTS[fit.font]);
+  u8g2_.drawStr(x, WORD_BASELINE[fit.font], word.c_str());
+}
+
+// Apps redraw the same message every frame, so the font is looked up by message before measuring
+PocketmageOled::WordFit PocketmageOled::fitWord_(const String& word, bool allowLarge) {
+  uint32_t hash = allowLarge ? 0x9E3779B9 : 2166136261u;   // FNV-1a
+  for (size_t i = 0; i < word.length(); i++) hash = (hash ^ (uint8_t)word[i]) * 16777619u;
+  for (const WordFit& fit : fits_) {
+    if (fit.hash == hash && fit.length == word.length()) return fit;
+  }
+
+  WordFit fit = {hash, (uint16_t)word.length(), 0, 0, false};
+  for (uint8_t i = allowLarge ? 0 : 1; i < WORD_FONT_COUNT && !fit.fits; i++) {
+    fit.font  = i;
+    fit.width = OledFontMetrics::of(u8g2_, WORD_FONTS[i]).width(word.c_str());
+    fit.fits  = fit.width < u8g2_.getDisplayWidth();
+  }
+  fits_[nextFit_++ % WORD_FITS] = fit;
+  return fit;
+}
+
+// Typing adds or removes characters at the end, so only those are measured
+void PocketmageOled::trackLine_(const String& line) {
+  const GFXfont*         font = EINK().getCurrentFont();
+  const OledFontMetrics& oled = OledFontMetrics::of(u8g2_, LINE_FONT);
+  auto einkAdvance = [font](char c) -> uint32_t {
+    if (!font || !font->glyph || (uint8_t)c < font->first || (uint8_t)c > font->last) return 0;
+    return pgm_read_byte(&font->glyph[(uint8_t)c - font->first].xAdvance);
+  };
+
+  const size_t had = line_.text.length();
+  const size_t has = line.length();
+  const char*  old = line_.text.c_str();
+  const char*  now = line.c_str();
+  size_t       keep;
+  if (font != line_.einkFont) keep = 0;
+  else if (has >= had && memcmp(now, old, had) == 0) keep = had;
+  else if (has < had && memcmp(now, old, has) == 0) keep = has;
+  else keep = 0;
+
+  if (keep == 0) {
+    line_.einkAdvance = 0;
+    line_.oledAdvance = 0;
+  }
+  for (size_t i = keep; i < had; i++) {
+    line_.einkAdvance -= einkAdvance(old[i]);
+    line_.oledAdvance -= oled.advance(old[i]);
+  }
+  for (size_t i = keep; i < has; i++) {
+    line_.einkAdvance += einkAdvance(now[i]);
+    line_.oledAdvance += oled.advance(now[i]);
+  }
+  line_.text     = line;
+  line_.einkFont = font;
+}
+
+uint16_t PocketmageOled::lineWidthOled_() {
+  const size_t length = line_.text.length();
+  if (length == 0) return 0;
+  const OledFontMetrics& oled = OledFontMetrics::of(u8g2_, LINE_FONT);
+  const char             last = line_.text[length - 1];
+  return line_.oledAdvance - oled.advance(last) + oled.tail(last);
+}
+
+void PocketmageOled::commit_(Layer layer) {
+  if (layer == LAYER_APP) appCommits_ = appCommits_ + 1;
+
+  if (!oledCompositorTaskHandle) {   // Nothing to composite with yet
+    SpiLease lease(SPI_DEVICE_OLED);
+    u8g2_.sendBuffer();
+    return;
+  }
+
+  {
+    OledLock lock(lock_);
+    memcpy(layers_[layer].data(), u8g2_.getBufferPtr(), layers_[layer].size());
+  }
+  xTaskNotifyGive(oledCompositorTaskHandle);
+}
+
+// Sends the topmost live layer, one u8x8_DrawTile() per run of changed tiles in each tile row.
+// Tiles go straight from front_, so drawing into u8g2's buffer meanwhile is harmless.
+void PocketmageOled::pushFrame_() {
+  bool full;
+  {
+    OledLock lock(lock_);
+    if (toastUntil_ && (long)(millis() - toastUntil_) >= 0) toastUntil_ = 0;
+    const std::vector<uint8_t>& top = layers_[toastUntil_ ? LAYER_TOAST : LAYER_APP];
+    memcpy(front_.data(), top.data(), front_.size());
+    full      = fullPush_;
+    fullPush_ = false;
+  }
+
+  const uint8_t tileWidth  = u8g2_.getBufferTileWidth();
+  const uint8_t tileHeight = u8g2_.getBufferTileHeight();
+  uint8_t*      frame      = front_.data();
+  uint8_t*      shown      = shadow_.data();
+
+  OledLock bus(bus_);
+  SpiLease lease(SPI_DEVICE_OLED);
+  u8x8_t*  u8x8 = u8g2_.getU8x8();
+  for (uint8_t ty = 0; ty < tileHeight; ty++) {
+    uint8_t tx = 0;
+    while (tx < tileWidth) {
+      const size_t at = ((size_t)ty * tileWidth + tx) * 8;
+      if (!full && memcmp(frame + at, shown + at, 8) == 0) {
+        tx++;
+        continue;
+      }
+
+      uint8_t run = 1;
+      while (tx + run < tileWidth &&
+             (full || memcmp(frame + at + run * 8, shown + at + run * 8, 8) != 0)) {
+        run++;
+      }
+      u8x8_DrawTile(u8x8, tx, ty, run, frame + at);
+      memcpy(shown + at, frame + at, run * 8);
+      tx += run;
+    }
+  }
+  u8x8_RefreshDisplay(u8x8);
+}
+
+void PocketmageOled::compositorTask_(void* parameter) {
+  PocketmageOled& oled     = OLED();
+  ulong           lastPush = 0;
+  for (;;) {
+    // Sleep until something is committed or the toast on top runs out
+    TickType_t timeout = portMAX_DELAY;
+    {
+      OledLock lock(oled.lock_);
+      if (oled.toastUntil_) {
+        const long left = (long)(oled.toastUntil_ - millis());
+        timeout = left > 0 ? pdMS_TO_TICKS(left) + 1 : 0;
+      }
+    }
+    ulTaskNotifyTake(pdTRUE, timeout);
+
+    // Hold to OLED_MAX_FPS; whatever is committed meanwhile goes out with this push
+    const ulong frameMs = 1000 / max(OLED_MAX_FPS, 1);
+    const long  wait    = (long)(lastPush + frameMs - millis());
+    if (wait > 0) vTaskDelay(pdMS_TO_TICKS(wait));
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    oled.pushFrame_();
+    lastPush = millis();
+  }
+}
+
+// ===================== OLED FONT METRICS =====================
+const OledFontMetrics& OledFontMetrics::of(U8G2& u8, const uint8_t* font) {
+  static std::vector<OledFontMetrics*> built;   // A handful of fonts, kept for good
+  for (const OledFontMetrics* metrics : built) {
+    if (metrics->font_ == font) return *metrics;
+  }
+
+  OledFontMetrics* metrics = new OledFontMetrics();
+  metrics->font_           = font;
+  u8.setFont(font);
+  char one[2] = {0, 0};
+  for (char c = ' '; c <= '~'; c++) {
+    one[0] = c;
+    metrics->advance_[c - ' '] = u8.getGlyphWidth(c);
+    // u8g2 counts the last glyph by its bitmap rather than its advance
+    metrics->tail_[c - ' '] = u8.getStrWidth(one);
+  }
+  built.push_back(metrics);
+  return *metrics;
+}
+
+uint16_t OledFontMetrics::width(const char* s) const {
+  int32_t width = 0;
+  char    last  = 0;
+  for (; *s; s++) {
+    width += advance(*s);
+    last = *s;
+  }
+  return last ? width - advance(last) + tail(last) : 0;
+}
@@ -16,19 +16,53 @@ extern bool SAVE_POWER;
 // Initialization of sd class
 static PocketmageSD pm_sd;
 
-// Helpers
-static int countVisibleChars(String input) {
-  int count = 0;
-
-  for (size_t i = 0; i < input.length(); i++) {
-    char c = input[i];
-    // Check if the character is a visible character or space
-    if (c >= 32 && c <= 126) {  // ASCII range for printable characters and space
-      count++;
+// ===================== DocStatsCounter =====================
+void DocStatsCounter::feed(const char* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    char c = data[i];
+    if (c == '\n') {
+      stats_.lines++;
+      endLine_();
+      continue;
+    }
+    lineOpen_ = true;
+
+    // ASCII range for printable characters and space
+    if (c >= 32 && c <= 126)
+      stats_.chars++;
+
+    // Anything but whitespace and control codes is part of a word (UTF-8 bytes included)
+    if ((uint8_t)c > 32 && c != 127) {
+      if (!inWord_) {
+        stats_.words++;
+        inWord_ = true;
+      }
+      lineHasText_ = true;
+    } else {
+      inWord_ = false;
     }
   }
+}
 
-  return count;
+DocStats DocStatsCounter::finish() {
+  // Last line without a trailing newline
+  if (lineOpen_) {
+    stats_.lines++;
+    endLine_();
+  }
+  return stats_;
+}
+
+void DocStatsCounter::endLine_() {
+  if (lineHasText_) {
+    if (!inParagraph_) stats_.paragraphs++;
+    inParagraph_ = true;
+  } else {
+    inParagraph_ = false;
+  }
+  inWord_      = false;
+  lineOpen_    = false;
+  lineHasText_ = false;
 }
 
 // Setup for SD Class
@@ -64,6 +98,7 @@ void setupSD() {
   pocketmage::setCpuSpeed(240);
   // Create folders and files if needed
   if (!SD_MMC.exists("/sys"))                 SD_MMC.mkdir( "/sys"                );
+  if (!SD_MMC.exists("/sys/layout"))          SD_MMC.mkdir( "/sys/layout"         );
   if (!SD_MMC.exists("/notes"))               SD_MMC.mkdir( "/notes"              );
   if (!SD_MMC.exists("/journal"))             SD_MMC.mkdir( "/journal"            );
   if (!SD_MMC.exists("/dict"))                SD_MMC.mkdir( "/dict"               );
@@ -72,15 +107,24 @@ void setupSD() {
   if (!SD_MMC.exists("/notes"))               SD_MMC.mkdir( "/notes"              );
   if (!SD_MMC.exists("/assets"))              SD_MMC.mkdir( "/assets"             );
   if (!SD_MMC.exists("/assets/backgrounds"))  SD_MMC.mkdir( "/assets/backgrounds" );
+  if (!SD_MMC.exists(FONTS_DIR))              SD_MMC.mkdir( FONTS_DIR             );
 
   if (!SD_MMC.exists("/assets/backgrounds/HOWTOADDBACKGROUNDS.txt")) {
     File f = SD_MMC.open("/assets/backgrounds/HOWTOADDBACKGROUNDS.txt", FILE_WRITE);
     if (f) {
-      f.print("How to add custom backgrounds:\n1. Make a background that is 1 bit (black OR white) and 320x240 pixels.\n2. Export your background as a .bmp file.\n3. Use image2cpp to convert your image to a .bin file. Use the settings: Invert Image Colors (TRUE), Swap Bits in Byte (FALSE). Select the \"Download as Binary File (.bin)\" button.\n4. Place the .bin file in this folder.\n5. Enjoy your new custom wallpapers!");
+      f.print("How to add custom backgrounds:\n1. Make a background that is 1 bit (black OR white) and 320x240 pixels.\n2. Export your background as a .bmp file.\n3. Use image2cpp to convert your image to a .bin file. Use the settings: Invert Image Colors (TRUE), Swap Bits in Byte (FALSE). Select the \"Download as Binary File (.bin)\" button.\n4. Optional: compress it with pmbconvert.py (Code/BackgroundConverter in the PocketMage repo) to get a smaller .pmb file.\n5. Place the .bin or .pmb file in this folder.\n6. Enjoy your new custom wallpapers!");
       f.close();
     }
   }
-  
+
+  if (!SD_MMC.exists(FONTS_DIR "/HOWTOADDFONTS.txt")) {
+    File f = SD_MMC.open(FONTS_DIR "/HOWTOADDFONTS.txt", FILE_WRITE);
+    if (f) {
+      f.print("How to add fonts:\nThe text app loads its fonts from this folder and falls back to small built-in ones for any that are missing.\n1. Copy the .pmf files from Code/FontConverter/fonts in the PocketMage repo here.\n2. To use a different font, make an Adafruit GFX font header with fontconvert, then convert it with pmfconvert.py (Code/FontConverter).\n3. Name the .pmf like the file it replaces (e.g. FreeSerif9pt8b.pmf for normal serif text) and place it in this folder.");
+      f.close();
+    }
+  }
+
   if (!SD_MMC.exists("/sys/events.txt")) {
     File f = SD_MMC.open("/sys/events.txt", FILE_WRITE);
     if (f) f.close();
@@ -122,7 +166,9 @@ void PocketmageSD::saveFile() {
       //OLED().oledWord("Saved: "+ editingFile);
 
       // Write MetaData
-      SD().writeMetadata(SD().getEditingFile());
+      DocStatsCounter counter;
+      counter.feed(textToSave);
+      SD().writeMetadata(SD().getEditingFile(), counter.finish());
 
       // delay(1000);
       keypad.enableInterrupts();
@@ -132,7 +178,30 @@ void PocketmageSD::saveFile() {
   }
 }
   
+// For files written without known stats, count them in small chunks. The stats overload
+// takes care of SDActive and the CPU speed.
 void PocketmageSD::writeMetadata(const String& path) {
+  File file = SD_MMC.open(path);
+  if (!file || file.isDirectory()) {
+      OLED().oledWord("META WRITE ERR");
+      delay(1000);
+      ESP_LOGE(TAG, "Invalid file for metadata: %s", path.c_str());
+      return;
+  }
+
+  DocStatsCounter counter;
+  uint8_t buf[512];
+  while (file.available()) {
+      size_t n = file.read(buf, sizeof(buf));
+      if (n == 0) break;
+      counter.feed((const char*)buf, n);
+  }
+  file.close();
+
+  writeMetadata(path, counter.finish());
+}
+
+void PocketmageSD::writeMetadata(const String& path, const DocStats& stats) {
   SDActive = true;
   pocketmage::setCpuSpeed(240);
   delay(50);
@@ -141,7 +210,10 @@ void PocketmageSD::writeMetadata(const String& path) {
   if (!file || file.isDirectory()) {
       OLED().oledWord("META WRITE ERR");
       delay(1000);
-      ESP_LOGE(TAG, "Invalid file for metadata: %s", path);
+      ESP_LOGE(TAG, "Invalid file for metadata: %s", path.c_str());
+      if (SAVE_POWER)
+      pocketmage::setCpuSpeed(POWER_SAVE_FREQ);
+      SDActive = false;
       return;
   }
   // Get file size
@@ -151,10 +223,9 @@ void PocketmageSD::writeMetadata(const String& path) {
   // Format size string
   String fileSizeStr = String(fileSizeBytes) + " Bytes";
 
-  // Get line and char counts
-  int charCount = countVisibleChars(SD().readFileToString(SD_MMC, path.c_str()));
-
-  String charStr = String(charCount) + " Char";
+  // Format counts
+  String charStr = String(stats.chars) + " Char|" + String(stats.words) + " Words|" +
+                   String(stats.lines) + " Lines|" + String(stats.paragraphs) + " Paras";
   // Get current time from RTC
   DateTime now = CLOCK().nowDT();
   char timestamp[20];
@@ -190,6 +261,9 @@ void PocketmageSD::writeMetadata(const String& path) {
   metaFile = SD_MMC.open(metaPath, FILE_WRITE);
   if (!metaFile) {
       ESP_LOGE(TAG, "Failed to open metadata file for writing: %s", metaPath);
+      if (SAVE_POWER)
+      pocketmage::setCpuSpeed(POWER_SAVE_FREQ);
+      SDActive = false;
       return;
   }
   metaFile.print(updatedMeta);
@@ -241,19 +315,21 @@ void PocketmageSD::delFile(String fileName) {
       delay(5000);
       return;
   } else {
+      if (!fileName.startsWith("/"))
+      fileName = "/" + fileName;
+      if (filesChanging_) filesChanging_(fileName);
       SDActive = true;
       pocketmage::setCpuSpeed(240);
       delay(50);
 
       keypad.disableInterrupts();
       // OLED().oledWord("Deleting File: "+ fileName);
-      if (!fileName.startsWith("/"))
-      fileName = "/" + fileName;
       SD().deleteFile(SD_MMC, fileName.c_str());
       // OLED().oledWord("Deleted: "+ fileName);
 
       // Delete MetaData
       SD().deleteMetadata(fileName);
+      if (fileName.startsWith(BACKGROUNDS_DIR)) invalidateBackgroundIndex();
 
       delay(1000);
       keypad.enableInterrupts();
@@ -311,22 +387,28 @@ void PocketmageSD::renFile(String oldFile, String newFile) {
       delay(5000);
       return;
   } else {
+      if (!oldFile.startsWith("/"))
+      oldFile = "/" + oldFile;
+      if (!newFile.startsWith("/"))
+      newFile = "/" + newFile;
+      if (filesChanging_) {
+        filesChanging_(oldFile);
+        filesChanging_(newFile);
+      }
       SDActive = true;
       pocketmage::setCpuSpeed(240);
       delay(50);
 
       keypad.disableInterrupts();
       // OLED().oledWord("Renaming "+ oldFile + " to " + newFile);
-      if (!oldFile.startsWith("/"))
-      oldFile = "/" + oldFile;
-      if (!newFile.startsWith("/"))
-      newFile = "/" + newFile;
       SD().renameFile(SD_MMC, oldFile.c_str(), newFile.c_str());
       OLED().oledWord(oldFile + " -> " + newFile);
       delay(1000);
 
       // Update MetaData
       SD().renMetadata(oldFile, newFile);
+      if (oldFile.startsWith(BACKGROUNDS_DIR) || newFile.startsWith(BACKGROUNDS_DIR))
+        invalidateBackgroundIndex();
 
       keypad.enableInterrupts();
       if (SAVE_POWER)
@@ -396,22 +478,26 @@ void PocketmageSD::renMetadata(String oldPath, String newPath) {
       delay(5000);
       return;
   } else {
+      if (!oldFile.startsWith("/"))
+      oldFile = "/" + oldFile;
+      if (!newFile.startsWith("/"))
+      newFile = "/" + newFile;
+      if (filesChanging_) filesChanging_(newFile);
       SDActive = true;
       pocketmage::setCpuSpeed(240);
       delay(50);
 
       keypad.disableInterrupts();
       OLED().oledWord("Loading File");
-      if (!oldFile.startsWith("/"))
-      oldFile = "/" + oldFile;
-      if (!newFile.startsWith("/"))
-      newFile = "/" + newFile;
       String textToLoad = SD().readFileToString(SD_MMC, (oldFile).c_str());
       SD().writeFile(SD_MMC, (newFile).c_str(), textToLoad.c_str());
       OLED().oledWord("Saved: " + newFile);
 
       // Write MetaData
-      SD().writeMetadata(newFile);
+      DocStatsCounter counter;
+      counter.feed(textToLoad);
+      SD().writeMetadata(newFile, counter.finish());
+      if (newFile.startsWith(BACKGROUNDS_DIR)) invalidateBackgroundIndex();
 
       delay(1000);
       keypad.enableInterrupts();
@@ -77,7 +77,7 @@ namespace pocketmage {
 
 
         // Put OLED to sleep
-        u8g2.setPowerSave(1);
+        OLED().setPowerSave(true);
 
         // Stop the einkHandler task
         if (einkHandlerTaskHandle != NULL) {
@@ -94,46 +94,30 @@ namespace pocketmage {
             pocketmage::setCpuSpeed(240);
             delay(50);
 
-            // Check if there are custom screensavers
-            File dir = SD_MMC.open("/assets/backgrounds");
-            std::vector<String> binFiles;
-
-            if (dir) {
-                File file;
-                while ((file = dir.openNextFile())) {
-                    String name = file.name();
-                    if (name.endsWith(".bin")) binFiles.push_back(name);
-                    file.close();
-                }
-                dir.close();
-            }
-
             display.setFullWindow();
 
-            // Use custom screensavers
-            if (!binFiles.empty()) {
-                int fileIndex = esp_random() % binFiles.size();
-                String path = "/assets/backgrounds/" + binFiles[fileIndex];
-                File f = SD_MMC.open(path);
-                if (f) {
-                    static uint8_t buf[320 * 240]; // Declare as static to avoid stack overflow :D
-                    f.read(buf, sizeof(buf));
-                    f.close();
-
-                    // Show file
-                    display.drawBitmap(0, 0, buf, 320, 240, GxEPD_BLACK);
+            // Use custom screensavers, streamed from the card (folder listing is cached)
+            String background = pickBackground();
+            bool customShown = false;
+            if (background.length() > 0) {
+                customShown = drawBackgroundFile(String(BACKGROUNDS_DIR) + "/" + background, display);
+                if (customShown) {
                     display.setFont(&FreeMonoBold9pt7b);
                     display.setTextColor(GxEPD_BLACK);
                     display.setCursor(5, display.height()-5);
-                    display.print(binFiles[fileIndex].c_str());
+                    display.print(background.c_str());
+                } else {
+                    // Stale index or bad file, list the folder again next time
+                    invalidateBackgroundIndex();
+                    display.fillScreen(GxEPD_WHITE);
                 }
             }
             // Use standard screensavers
-            else {
-                int numScreensavers = sizeof(ScreenSaver_allArray) / sizeof(ScreenSaver_allArray[0]);
+            if (!customShown) {
+                int numScreensavers = ASSET_SCREENSAVER17 - ASSET_SCREENSAVER0 + 1;
                 int randomScreenSaver_ = esp_random() % numScreensavers;
 
-                display.drawBitmap(0, 0, ScreenSaver_allArray[randomScreenSaver_], 320, 240, GxEPD_BLACK);
+                ASSETS().draw(ASSET_SCREENSAVER0 + randomScreenSaver_, 0, 0, display);
             }
 
 
@@ -141,11 +125,6 @@ namespace pocketmage {
             SDActive = false;
 
             EINK().multiPassRefresh(2);
-        } else {
-            // Display alternate screensaver
-            EINK().forceSlowFullUpdate(true);
-            EINK().refresh();
-            delay(100);
         }
         // essential to display next app correctly 
         display.setFullWindow();
@@ -283,7 +262,7 @@ void PocketMage_INIT(){
 }
 
 // ===================== GLOBAL TEXT HELPERS =====================
-volatile bool newLineAdded = true;           // New line added in TXT
+RedrawFlag newLineAdded(true);               // New line added in TXT
 std::vector<String> allLines;         // All lines in TXT
 
 String vectorToString() {
@@ -0,0 +1,76 @@
+#include <pocketmage.h>
+
+static constexpr const char* tag = "SPI_BUS";
+
+static constexpr const char* DEVICE_NAMES[SPI_DEVICE_COUNT] = {"OLED", "EINK"};
+
+static SpiBus pm_spiBus;
+
+SpiBus& SPIBUS() { return pm_spiBus; }
+
+// ===================== SPI BUS =====================
+void SpiBus::acquire(SpiDevice device) {
+  const uint32_t queued = micros();
+
+  // Created on first use; no allocating inside the critical section
+  SemaphoreHandle_t spare = lock_ ? nullptr : xSemaphoreCreateMutex();
+  portENTER_CRITICAL(&mux_);
+  if (!lock_) {
+    lock_ = spare;
+    spare = nullptr;
+  }
+  waiting_[device]++;
+  portEXIT_CRITICAL(&mux_);
+  if (spare) vSemaphoreDelete(spare);
+
+  for (;;) {
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    if (!higherWaiting_(device)) break;
+    // Someone more urgent is queued: step aside until it has had its turn
+    xSemaphoreGive(lock_);
+    vTaskDelay(1);
+  }
+
+  portENTER_CRITICAL(&mux_);
+  waiting_[device]--;
+  portEXIT_CRITICAL(&mux_);
+
+  since_              = micros();
+  const uint32_t wait = since_ - queued;
+  Stats&         s    = stats_[device];
+  s.leases++;
+  s.waitUs += wait;
+  if (wait > s.maxWaitUs) s.maxWaitUs = wait;
+}
+
+void SpiBus::release(SpiDevice device) {
+  stats_[device].busyUs += micros() - since_;
+  xSemaphoreGive(lock_);
+}
+
+SpiBus::Stats SpiBus::stats(SpiDevice device) const {
+  return stats_[device];
+}
+
+void SpiBus::resetStats() {
+  for (Stats& s : stats_) s = {};
+  statsFrom_ = micros();
+}
+
+void SpiBus::logStats() {
+  const uint32_t window = max<uint32_t>(micros() - statsFrom_, 1);
+  for (uint8_t d = 0; d < SPI_DEVICE_COUNT; d++) {
+    const Stats& s = stats_[d];
+    ESP_LOGD(tag, "%s: %.1f%% busy, %u leases, wait avg %u us max %u us", DEVICE_NAMES[d],
+             s.busyUs * 100.0f / window, (unsigned)s.leases,
+             (unsigned)(s.leases ? s.waitUs / s.leases : 0), (unsigned)s.maxWaitUs);
+  }
+  resetStats();
+}
+
+bool SpiBus::higherWaiting_(SpiDevice device) const {
+  for (uint8_t d = 0; d < device; d++) {
+    if (waiting_[d]) return true;
+  }
+  return false;
+}
@@ -0,0 +1,125 @@
+#include <pocketmage.h>
+
+static constexpr uint32_t PUNCT_FIRST = 0x2000;
+static constexpr uint32_t PUNCT_LAST  = 0x20AF;
+static constexpr uint8_t  GLYPH_NONE  = 0;   // Zero width, nothing drawn
+
+// Glyph bytes for U+0000-U+017F and for U+2000-U+20AF (general punctuation and currency),
+// filled once at boot
+struct GlyphTables {
+  uint8_t latin[0x180];
+  uint8_t punct[PUNCT_LAST - PUNCT_FIRST + 1];
+
+  GlyphTables() {
+    for (uint32_t cp = 0; cp < 0x180; cp++) {
+      if (cp < 0x7F)                      latin[cp] = cp;
+      else if (cp >= 0xA0 && cp < 0x100)  latin[cp] = cp - 0x20;
+      else                                latin[cp] = GLYPH_FALLBACK;
+    }
+    // Latin-1 characters whose slots hold other glyphs
+    for (uint32_t cp : {0xA4, 0xA6, 0xA8, 0xB4, 0xB8, 0xBC, 0xBD, 0xBE}) latin[cp] = GLYPH_FALLBACK;
+    latin[0x160] = 0x86;   // Š
+    latin[0x161] = 0x88;   // š
+    latin[0x17D] = 0x94;   // Ž
+    latin[0x17E] = 0x98;   // ž
+    latin[0x152] = 0x9C;   // Œ
+    latin[0x153] = 0x9D;   // œ
+    latin[0x178] = 0x9E;   // Ÿ
+
+    // Typographic punctuation falls back to its plain ASCII form
+    memset(punct, GLYPH_FALLBACK, sizeof(punct));
+    memset(punct, ' ', 0x0B);                               // En quad to hair space
+    memset(punct + 0x0B, GLYPH_NONE, 5);                    // Zero width space, joiners, marks
+    memset(punct + 0x10, '-', 6);                           // Hyphens and dashes
+    memset(punct + 0x18, '\'', 4);                          // Single quotes
+    memset(punct + 0x1C, '"', 4);                           // Double quotes
+    punct[0x22] = 0x97;                                     // Bullet as a middle dot
+    punct[0x2F] = 0x80;                                     // Narrow no-break space
+    punct[0x32] = '\'';                                     // Prime
+    punct[0x33] = '"';                                      // Double prime
+    punct[0x39] = '<';
+    punct[0x3A] = '>';
+    punct[0x60] = GLYPH_NONE;                               // Word joiner
+    punct[0xAC] = 0x84;                                     // €
+  }
+};
+
+static const GlyphTables glyphTables;
+
+uint8_t glyphFor(uint32_t cp) {
+  if (cp < 0x180) return glyphTables.latin[cp];
+  if (cp - PUNCT_FIRST <= PUNCT_LAST - PUNCT_FIRST) return glyphTables.punct[cp - PUNCT_FIRST];
+  if (cp == 0xFEFF) return GLYPH_NONE;   // Byte order mark
+  return GLYPH_FALLBACK;
+}
+
+uint32_t utf8Next(const char*& s) {
+  const uint8_t lead = *s;
+  if (lead < 0x80) {
+    s++;
+    return lead;
+  }
+
+  uint8_t  extra;
+  uint32_t cp;
+  if ((lead & 0xE0) == 0xC0)      { extra = 1; cp = lead & 0x1F; }
+  else if ((lead & 0xF0) == 0xE0) { extra = 2; cp = lead & 0x0F; }
+  else if ((lead & 0xF8) == 0xF0) { extra = 3; cp = lead & 0x07; }
+  else {
+    s++;
+    return lead;   // Stray byte, read as Latin-1
+  }
+
+  // A terminator fails the continuation test, so this never reads past the string
+  for (uint8_t i = 1; i <= extra; i++) {
+    const uint8_t c = s[i];
+    if ((c & 0xC0) != 0x80) {
+      s++;
+      return lead;
+    }
+    cp = (cp << 6) | (c & 0x3F);
+  }
+  s += extra + 1;
+  return cp;
+}
+
+size_t utf8LastLength(const String& s) {
+  const size_t len = s.length();
+  if (len == 0) return 0;
+
+  size_t n = 1;
+  while (n < 4 && n < len && ((uint8_t)s[len - n] & 0xC0) == 0x80) n++;
+  const uint8_t lead = s[len - n];
+  const size_t  want = (lead & 0xE0) == 0xC0 ? 2
+                      : (lead & 0xF0) == 0xE0 ? 3
+                      : (lead & 0xF8) == 0xF0 ? 4
+                                              : 1;
+  return want == n ? n : 1;   // Malformed tails go one byte at a time
+}
+
+// ===================== GLYPH TEXT =====================
+GlyphText::GlyphText(const char* utf8) {
+  const char* p = utf8;
+  while (*p && !(*p & 0x80)) p++;
+  if (!*p) {
+    text_ = utf8;
+    return;
+  }
+
+  // Never more glyphs than bytes
+  const size_t len = p - utf8 + strlen(p);
+  char*        out = short_;
+  if (len >= sizeof(short_)) {
+    long_.reset(new char[len + 1]);
+    out = long_.get();
+  }
+  text_ = out;
+
+  memcpy(out, utf8, p - utf8);
+  out += p - utf8;
+  while (*p) {
+    const uint8_t glyph = glyphFor(utf8Next(p));
+    if (glyph != GLYPH_NONE) *out++ = glyph;
+  }
+  *out = '\0';
+}
@@ -628,7 +628,7 @@ void drawProgressBar(uint8_t progress) {
   u8g2.drawStr((u8g2.getDisplayWidth() - u8g2.getStrWidth(progressText.c_str()))/2,
                u8g2.getDisplayHeight()-3,progressText.c_str());
 
-  u8g2.sendBuffer();
+  OLED().sendBuffer();
 }
 
 // ---------- Operations ----------
@@ -838,7 +838,7 @@ void einkHandler_APPLOADER() {
       if (newState) {
         newState = false;
         EINK().resetDisplay(false);
-        display.drawBitmap(0, 0, _appLoader, 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_APP_LOADER, 0, 0, display);
 
         loadAndDrawAppIcon(42 , 146, 1, true, 7);  // OTA1
         loadAndDrawAppIcon(106, 146, 2, true, 7);  // OTA2
@@ -720,7 +720,7 @@ void drawCalendarMonth(int monthOffset) {
 
   // Draw Background
   EINK().drawStatusBar(getMonthName(currentMonth) + " " + String(currentYear)+ " | Type a Date:");
-  display.drawBitmap(0, 0, calendar_allArray[1], 320, 218, GxEPD_BLACK);
+  ASSETS().draw(ASSET_CALENDAR01, 0, 0, display);
 
   // Step 2: Day of the week for the 1st of the month (0 = Sun, 6 = Sat)
   DateTime firstDay(year, month, 1);
@@ -801,7 +801,7 @@ void drawCalendarMonth(int monthOffset) {
 
 void drawCalendarWeek(int weekOffset) {
   EINK().drawStatusBar("Type Sun, etc. or (N)ew");
-  display.drawBitmap(0, 0, calendar_allArray[0], 320, 218, GxEPD_BLACK);
+  ASSETS().draw(ASSET_CALENDAR00, 0, 0, display);
 
   // Get current date
   DateTime now = CLOCK().nowDT();
@@ -1608,7 +1608,7 @@ void einkHandler_CALENDAR() {
         newState = false;
         EINK().resetDisplay();
 
-        display.drawBitmap(0, 0, calendar_allArray[2], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_CALENDAR02, 0, 0, display);
 
         display.setFont(&FreeSerif9pt7b);
 
@@ -1647,7 +1647,7 @@ void einkHandler_CALENDAR() {
             EINK().drawStatusBar("Type the info!");
             break;
         }
-        display.drawBitmap(0, 0, calendar_allArray[3], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_CALENDAR03, 0, 0, display);
 
         display.setFont(&FreeSerif9pt7b);
 
@@ -1689,7 +1689,7 @@ void einkHandler_CALENDAR() {
         // CurrentCalendarState enumerations somehow line up with calendar app bitmaps?
         // SUN = 4, SAT = 10
         EINK().drawStatusBar("Events 1-7 or (N)ew");
-        display.drawBitmap(0, 0, calendar_allArray[CurrentCalendarState], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_CALENDAR00 + CurrentCalendarState, 0, 0, display);
 
         // Draw Date
         display.setFont(&FreeSerif9pt7b);
@@ -9,12 +9,14 @@
 #include <globals.h>
 #if !OTA_APP // POCKETMAGE_OS
 
-enum FileWizState { WIZ0_, WIZ1_, WIZ1_YN, WIZ2_R, WIZ2_C, WIZ3_ };
+enum FileWizState { WIZ0_, WIZ1_, WIZ1_YN, WIZ2_R, WIZ2_C, WIZ3_, WIZ_VIEW };
 FileWizState CurrentFileWizState = WIZ0_;
 
 String currentWord = "";
 static String currentLine = "";
 bool refreshFiles = false;
+static String viewPath = "";
+static ImageDither viewDither = DITHER_FLOYD_STEINBERG;
 
 std::vector<String> excludedPaths = {
   "/sys",
@@ -208,7 +210,7 @@ String renderWizMini(String folder, int8_t scrollDelta) {
       break;
   }
 
-  u8g2.sendBuffer();
+  OLED().sendBuffer();
 
   return cachedFiles[scroll].address;
 }
@@ -343,8 +345,14 @@ void processKB_FILEWIZ() {
         break;
       }
       else if (outPath != "") {
+        // Show image
+        if (isImageFile(outPath)) {
+          viewPath = outPath;
+          CurrentFileWizState = WIZ_VIEW;
+          newState = true;
+        }
         // Open file
-        if (outPath != "-" && outPath != "") {
+        else if (outPath != "-" && outPath != "") {
           SD().setWorkingFile(outPath);
           // GO TO WIZ1_
           CurrentFileWizState = WIZ1_;
@@ -608,6 +616,36 @@ void processKB_FILEWIZ() {
         }
       }
       break;
+    case WIZ_VIEW:
+      disableTimeout = false;
+
+      currentMillis = millis();
+      if (currentMillis - KBBounceMillis >= KB_COOLDOWN) {  
+        char inchar = KB().updateKeypress();
+        //No char recieved
+        if (inchar == 0);
+        //BKSP Recieved
+        else if (inchar == 127 || inchar == 8 || inchar == 12) {
+          CurrentFileWizState = WIZ0_;
+          newState = true;
+          break;
+        }
+        // D RECIEVED (switch dithering)
+        else if (inchar == 'd' || inchar == 'D') {
+          viewDither = (viewDither == DITHER_ORDERED) ? DITHER_FLOYD_STEINBERG : DITHER_ORDERED;
+          newState = true;
+        }
+
+        currentMillis = millis();
+        //Make sure oled only updates at OLED_MAX_FPS
+        if (currentMillis - OLEDFPSMillis >= (1000/OLED_MAX_FPS)) {
+          OLEDFPSMillis = currentMillis;
+          String name = viewPath.substring(viewPath.lastIndexOf('/') + 1);
+          OLED().oledLine(name, false, "D:Dither BKSP:Back");
+        }
+        KBBounceMillis = currentMillis;
+      }
+      break;
   
   }
 }
@@ -621,7 +659,7 @@ void einkHandler_FILEWIZ() {
 
         // DRAW APP
         EINK().drawStatusBar("Select a File (0-9)");
-        display.drawBitmap(0, 0, fileWizardallArray[0], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ0, 0, 0, display);
 
         // DRAW FILE LIST
 
@@ -645,7 +683,7 @@ void einkHandler_FILEWIZ() {
 
         // DRAW APP
         EINK().drawStatusBar("- " + SD().getWorkingFile());
-        display.drawBitmap(0, 0, fileWizardallArray[1], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ1, 0, 0, display);
 
         EINK().refresh();
       }
@@ -657,7 +695,7 @@ void einkHandler_FILEWIZ() {
 
         // DRAW APP
         EINK().drawStatusBar("DEL:" + SD().getWorkingFile() + "?(Y/N)");
-        display.drawBitmap(0, 0, fileWizardallArray[1], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ1, 0, 0, display);
 
         EINK().refresh();
       }
@@ -669,7 +707,7 @@ void einkHandler_FILEWIZ() {
 
         // DRAW APP
         EINK().drawStatusBar("Enter New Filename:");
-        display.drawBitmap(0, 0, fileWizardallArray[2], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ2, 0, 0, display);
 
         EINK().refresh();
       }
@@ -681,7 +719,24 @@ void einkHandler_FILEWIZ() {
 
         // DRAW APP
         EINK().drawStatusBar("Enter Name For Copy:");
-        display.drawBitmap(0, 0, fileWizardallArray[2], 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ2, 0, 0, display);
+
+        EINK().refresh();
+      }
+      break;
+    case WIZ_VIEW:
+      if (newState) {
+        newState = false;
+        EINK().resetDisplay();
+
+        // DRAW IMAGE (streamed from SD a row at a time)
+        SDActive = true;
+        pocketmage::setCpuSpeed(240);
+        bool shown = drawImageFile(viewPath, display, viewDither);
+        if (SAVE_POWER) pocketmage::setCpuSpeed(POWER_SAVE_FREQ);
+        SDActive = false;
+
+        if (!shown) EINK().drawStatusBar("Can't open image");
 
         EINK().refresh();
       }
@@ -239,6 +239,17 @@ void resetIdle() {
   resetIdleAnim = true;
 }
 
+// Idle mage clips, right-facing; the sprite mirrors them when the mage runs left
+enum MageClip { CLIP_IDLE, CLIP_TRANSITION, CLIP_RUN };
+
+static SpriteAtlas buildMageAtlas() {
+  SpriteAtlas atlas;
+  atlas.addClip(idle_right_allArray, 7, 29, 29);    // CLIP_IDLE
+  atlas.addClip(trans_right_allArray, 5, 29, 29);   // CLIP_TRANSITION
+  atlas.addClip(run_right_allArray, 6, 29, 29);     // CLIP_RUN, loops over the first 6 frames
+  return atlas;
+}
+
 void mageIdle(bool internalRefresh) {
   enum MageState { IDLE, RUN_LEFT, RUN_RIGHT};
   static MageState CurrentMageState = RUN_RIGHT;
@@ -250,6 +261,15 @@ void mageIdle(bool internalRefresh) {
   static long internalMillis = 0;
   static int runSpeed = 3;
 
+  static const SpriteAtlas mageAtlas = buildMageAtlas();
+  static OledSprite mage(mageAtlas);
+  static bool fullRedraw = true;
+  static uint32_t lastInfoBar = 0;
+  static int lastKbState = -1;
+  static uint32_t lastCommit = 0;
+  const int MAGE_Y = -1;
+  const int INFO_BAR_TOP = u8g2.getDisplayHeight() - 7;
+
   uint32_t chance = 1;
 
   if (resetIdleAnim) {
@@ -261,6 +281,7 @@ void mageIdle(bool internalRefresh) {
     internalMillis = 0;
     runSpeed = 3;
     CurrentMageState = RUN_RIGHT;
+    fullRedraw = true;
 
     resetIdleAnim = false;
   }
@@ -273,14 +294,15 @@ void mageIdle(bool internalRefresh) {
   if (millis() - lastUpdate < FRAME_INTERVAL) return; // skip until next frame
   lastUpdate = millis();
 
-  if (internalRefresh) u8g2.clearBuffer();
-  u8g2.setBitmapMode(1);
+  MageClip clip = CLIP_IDLE;
+  uint8_t frame = 0;
+  const int drawPosition = MagePosition;
 
   switch (CurrentMageState) {
     case IDLE:
       // Idle animation (half frames)
-      if (MageDirection)  u8g2.drawXBMP(MagePosition,-1,29,29,idle_right_allArray[(internalMillis/4) % 7]);
-      else                u8g2.drawXBMP(MagePosition,-1,29,29,idle_left_allArray[(internalMillis/4) % 7]);
+      clip = CLIP_IDLE;
+      frame = (internalMillis/4) % 7;
 
       // 1 in 50 chance to stop idling (0-5 sec)
       chance = (esp_random() % 50);
@@ -299,14 +321,16 @@ void mageIdle(bool internalRefresh) {
     case RUN_LEFT:
       MageDirection = false;
       
-      // Display animation frame
+      // Animation frame
       if (progress < 5) {
-        u8g2.drawXBMP(MagePosition,-1,29,29,trans_left_allArray[progress]);      // Transition for first 5 frames
+        clip = CLIP_TRANSITION;                 // Transition for first 5 frames
+        frame = progress;
         progress++;
         MagePosition--;
       }
       else {
-        u8g2.drawXBMP(MagePosition,-1,29,29,run_left_allArray[(progress-5)%6]);  // Rest of frames are running
+        clip = CLIP_RUN;                        // Rest of frames are running
+        frame = (progress-5) % 6;
         progress++;
         MagePosition-=runSpeed;
       }
@@ -321,14 +345,16 @@ void mageIdle(bool internalRefresh) {
     case RUN_RIGHT:
       MageDirection = true;
       
-      // Display animation frame
+      // Animation frame
       if (progress < 5) {
-        u8g2.drawXBMP(MagePosition,-1,29,29,trans_right_allArray[progress]);      // Transition for first 5 frames
+        clip = CLIP_TRANSITION;                 // Transition for first 5 frames
+        frame = progress;
         progress++;
         MagePosition++;
       }
       else {
-        u8g2.drawXBMP(MagePosition,-1,29,29,run_right_allArray[(progress-5)%6]);  // Rest of frames are running
+        clip = CLIP_RUN;                        // Rest of frames are running
+        frame = (progress-5) % 6;
         progress++;
         MagePosition+=runSpeed;
       }             
@@ -341,10 +367,43 @@ void mageIdle(bool internalRefresh) {
       break;
   }
 
-  if (internalRefresh) {
+  // Caller owns the buffer and sends it
+  if (!internalRefresh) {
+    mage.reset();
+    mage.draw(u8g2, clip, frame, !MageDirection, drawPosition, MAGE_Y);
+    fullRedraw = true;
+    return;
+  }
+
+  // Only the sprite's changed rows are redrawn; the rest of the buffer is kept between frames,
+  // unless something else has drawn into it and sent it since (sleep or battery messages, ...)
+  if (OLED().appCommits() != lastCommit) fullRedraw = true;
+  if (fullRedraw) {
+    u8g2.clearBuffer();
+    mage.reset();
+  }
+  const uint32_t touched = mage.draw(u8g2, clip, frame, !MageDirection, drawPosition, MAGE_Y);
+
+  // The info bar shares its rows with the mage's feet: redo it when those changed, the
+  // keyboard state changed or the clock may have ticked
+  const int kbState = KB().getKeyboardState();
+  const bool infoBarDue = fullRedraw || kbState != lastKbState || millis() - lastInfoBar >= 1000 ||
+                          (touched >> (INFO_BAR_TOP - MAGE_Y));
+  if (infoBarDue) {
+    u8g2.setDrawColor(0);
+    u8g2.drawBox(0, INFO_BAR_TOP, u8g2.getDisplayWidth(), u8g2.getDisplayHeight() - INFO_BAR_TOP);
+    u8g2.setDrawColor(1);
     OLED().infoBar();
-    u8g2.sendBuffer();
+    mage.redraw(u8g2);
+    lastInfoBar = millis();
+    lastKbState = kbState;
+  }
+
+  if (touched || infoBarDue) {
+    OLED().sendBuffer();
+    lastCommit = OLED().appCommits();
   }
+  fullRedraw = false;
 }
 
 void processKB_HOME() {
@@ -458,7 +517,7 @@ void einkHandler_HOME() {
         newState = false;
 
         // BACKGROUND
-        display.drawBitmap(0, 0, nowLaterallArray[0], 320, 240, GxEPD_BLACK);
+        ASSETS().draw(ASSET_NOW_LATER0, 0, 0, display);
 
         // CLOCK HANDS
         float pi = 3.14159;
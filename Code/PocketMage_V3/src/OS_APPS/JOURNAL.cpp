@@ -43,7 +43,7 @@ void drawJMENU() {
 
   // Display background
   EINK().drawStatusBar("Type:YYYYMMDD or (T)oday");
-  display.drawBitmap(0, 0, _journal, 320, 218, GxEPD_BLACK);
+  ASSETS().draw(ASSET_JOURNAL, 0, 0, display);
 
   // Update current progress graph
   DateTime now = CLOCK().nowDT();
@@ -330,7 +330,7 @@ void einkHandler_LEXICON() {
       if (newState) {
         newState = false;
         EINK().resetDisplay(false);
-        display.drawBitmap(0, 0, _lex0, 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_LEXICON0, 0, 0, display);
 
         EINK().drawStatusBar("Type a Word:");
 
@@ -341,7 +341,7 @@ void einkHandler_LEXICON() {
       if (newState) {
         newState = false;
 
-        display.drawBitmap(0, 0, _lex1, 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_LEXICON1, 0, 0, display);
 
         display.setTextColor(GxEPD_BLACK);
 
@@ -48,7 +48,7 @@ void settingCommandSelect(String command) {
     else if (lumina > 255) lumina = 255;
     else if (lumina < 0) lumina = 0;
     OLED_BRIGHTNESS = lumina;
-    u8g2.setContrast(OLED_BRIGHTNESS);
+    OLED().setContrast(OLED_BRIGHTNESS);
     prefs.begin("PocketMage", false);
     prefs.putInt("OLED_BRIGHTNESS", OLED_BRIGHTNESS);
     prefs.end();
@@ -301,7 +301,7 @@ void einkHandler_settings() {
     
     // Display Background
     display.fillScreen(GxEPD_WHITE);
-    display.drawBitmap(0, 0, _settings, 320, 218, GxEPD_BLACK);
+    ASSETS().draw(ASSET_SETTINGS, 0, 0, display);
 
     display.setFont(&FreeSerif9pt7b);
     // First column of settings
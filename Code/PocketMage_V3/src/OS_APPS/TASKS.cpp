@@ -332,7 +332,7 @@ void einkHandler_TASKS() {
         EINK().resetDisplay();
 
         // DRAW APP
-        display.drawBitmap(0, 0, tasksApp0, 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_TASKS0, 0, 0, display);
 
         // DRAW FILE LIST
         updateTaskArray();
@@ -367,7 +367,7 @@ void einkHandler_TASKS() {
           EINK().resetDisplay();
 
           // DRAW APP
-          display.drawBitmap(0, 0, tasksApp0, 320, 218, GxEPD_BLACK);
+          ASSETS().draw(ASSET_TASKS0, 0, 0, display);
 
           // DRAW FILE LIST
           updateTaskArray();
@@ -409,7 +409,7 @@ void einkHandler_TASKS() {
 
         // DRAW APP
         EINK().drawStatusBar("T:" + tasks[selectedTask][0]);
-        display.drawBitmap(0, 0, tasksApp1, 320, 218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_TASKS1, 0, 0, display);
 
         EINK().refresh();
       }
@@ -17,6 +17,13 @@ String prevEditingFile = "";
 static String currentLine = "";
 static volatile bool doFull = false;
 
+// The input loop runs on the other core, so the e-ink task does the clearing
+static void clearEinkBuffer() {
+  EinkDisplayList clear;
+  clear.fillScreen(GxEPD_WHITE);
+  EINK().submit(std::move(clear));
+}
+
 
 void TXT_INIT_OLD() {
   if (SD().getEditingFile() != "") SD().loadFile();
@@ -207,7 +214,7 @@ void processKB_TXT_OLD() {
           newLineAdded = true;
           currentWord = "";
           currentLine = "";
-          display.fillScreen(GxEPD_WHITE);
+          clearEinkBuffer();
         }
         else if (inchar >= '0' && inchar <= '9'){
           int fileIndex = (inchar == '0') ? 10 : (inchar - '0');
@@ -218,7 +225,7 @@ void processKB_TXT_OLD() {
               CurrentTXTState = WIZ3;
               EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
               newState = true;
-              display.fillScreen(GxEPD_WHITE);
+              clearEinkBuffer();
             }
             //Selected file exists, prompt to save current file
             else {      
@@ -227,7 +234,7 @@ void processKB_TXT_OLD() {
               CurrentTXTState = WIZ1;
               EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
               newState = true;
-              display.fillScreen(GxEPD_WHITE);
+              clearEinkBuffer();
             }
           }
           //Selected file is current file, return to editor
@@ -237,7 +244,7 @@ void processKB_TXT_OLD() {
             newLineAdded = true;
             currentWord = "";
             currentLine = "";
-            display.fillScreen(GxEPD_WHITE);
+            clearEinkBuffer();
           }
 
         }
@@ -258,7 +265,7 @@ void processKB_TXT_OLD() {
           KB().setKeyboardState(FUNC);
           EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
           newState = true;
-          display.fillScreen(GxEPD_WHITE);
+          clearEinkBuffer();
         }
         else if (inchar >= '0' && inchar <= '9'){
           int numSelect = (inchar == '0') ? 10 : (inchar - '0');
@@ -271,7 +278,7 @@ void processKB_TXT_OLD() {
               KB().setKeyboardState(NORMAL);
               EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
               newState = true;
-              display.fillScreen(GxEPD_WHITE);
+              clearEinkBuffer();
             }
             //File to be saved exists
             else {
@@ -287,7 +294,7 @@ void processKB_TXT_OLD() {
               newLineAdded = true;
               currentWord = "";
               currentLine = "";
-              display.fillScreen(GxEPD_WHITE);
+              clearEinkBuffer();
             }
           }
           //NO  (don't save current file)
@@ -300,7 +307,7 @@ void processKB_TXT_OLD() {
             newLineAdded = true;
             currentWord = "";
             currentLine = "";
-            display.fillScreen(GxEPD_WHITE);
+            clearEinkBuffer();
           }
         }
 
@@ -463,7 +470,7 @@ void processKB_TXT_OLD() {
           newLineAdded = true;
           currentWord = "";
           currentLine = "";
-          display.fillScreen(GxEPD_WHITE);
+          clearEinkBuffer();
         }
         else if (inchar >= '0' && inchar <= '9') {
           int fontIndex = (inchar == '0') ? 10 : (inchar - '0');
@@ -505,7 +512,7 @@ void processKB_TXT_OLD() {
           newLineAdded = true;
           currentWord = "";
           currentLine = "";
-          display.fillScreen(GxEPD_WHITE);
+          clearEinkBuffer();
         }
 
         currentMillis = millis();
@@ -546,7 +553,7 @@ void einkHandler_TXT_OLD() {
         display.drawBitmap(display.width()-30,display.height()-20, KBStatusallArray[6], 30, 20, GxEPD_BLACK);
 
         display.fillRect(60,0,200,218,GxEPD_WHITE);
-        display.drawBitmap(60,0,fileWizLiteallArray[0],200,218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ_LITE0, 60, 0, display);
 
         keypad.disableInterrupts();
         SD().listDir(SD_MMC, "/");
@@ -570,7 +577,7 @@ void einkHandler_TXT_OLD() {
         display.drawBitmap(display.width()-30,display.height()-20, KBStatusallArray[6], 30, 20, GxEPD_BLACK);
 
         display.fillRect(60,0,200,218,GxEPD_WHITE);
-        display.drawBitmap(60,0,fileWizLiteallArray[1],200,218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ_LITE1, 60, 0, display);
 
         EINK().refresh();
         KB().setKeyboardState(FUNC);
@@ -585,7 +592,7 @@ void einkHandler_TXT_OLD() {
         display.drawBitmap(display.width()-30,display.height()-20, KBStatusallArray[6], 30, 20, GxEPD_BLACK);
 
         display.fillRect(60,0,200,218,GxEPD_WHITE);
-        display.drawBitmap(60,0,fileWizLiteallArray[2],200,218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ_LITE2, 60, 0, display);
 
         EINK().refresh();
         KB().setKeyboardState(NORMAL);
@@ -602,7 +609,7 @@ void einkHandler_TXT_OLD() {
         display.drawBitmap(display.width()-30,display.height()-20, KBStatusallArray[6], 30, 20, GxEPD_BLACK);
 
         display.fillRect(60,0,200,218,GxEPD_WHITE);
-        display.drawBitmap(60,0,fileWizLiteallArray[3],200,218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FILEWIZ_LITE3, 60, 0, display);
 
         EINK().refresh();
         KB().setKeyboardState(NORMAL);
@@ -614,7 +621,7 @@ void einkHandler_TXT_OLD() {
         EINK().drawStatusBar("Select a Font (0-9)");
 
         display.fillRect(60,0,200,218,GxEPD_WHITE);
-        display.drawBitmap(60,0,fontfont0,200,218, GxEPD_BLACK);
+        ASSETS().draw(ASSET_FONT_PICKER, 60, 0, display);
 
         keypad.disableInterrupts();
         SD().listDir(SD_MMC, "/");
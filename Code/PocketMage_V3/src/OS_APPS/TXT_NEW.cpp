@@ -10,49 +10,14 @@
 #if !OTA_APP // POCKETMAGE_OS
 static constexpr const char* TAG = "TXT_NEWz";
 
-// Font includes
-// Mono
-#include <Fonts/FreeMono9pt8b.h>
-#include <Fonts/FreeMonoBold12pt8b.h>
-#include <Fonts/FreeMonoBold18pt8b.h>
-#include <Fonts/FreeMonoBold24pt8b.h>
-#include <Fonts/FreeMonoBold9pt8b.h>
-#include <Fonts/FreeMonoBoldOblique12pt8b.h>
-#include <Fonts/FreeMonoBoldOblique18pt8b.h>
-#include <Fonts/FreeMonoBoldOblique24pt8b.h>
-#include <Fonts/FreeMonoBoldOblique9pt8b.h>
-#include <Fonts/FreeMonoOblique9pt8b.h>
-
-// Serif
-#include <Fonts/FreeSerif9pt8b.h>
-#include <Fonts/FreeSerifBold12pt8b.h>
-#include <Fonts/FreeSerifBold18pt8b.h>
-#include <Fonts/FreeSerifBold24pt8b.h>
-#include <Fonts/FreeSerifBold9pt8b.h>
-#include <Fonts/FreeSerifBoldItalic12pt8b.h>
-#include <Fonts/FreeSerifBoldItalic18pt8b.h>
-#include <Fonts/FreeSerifBoldItalic24pt8b.h>
-#include <Fonts/FreeSerifBoldItalic9pt8b.h>
-#include <Fonts/FreeSerifItalic9pt8b.h>
-
-// Sans
-#include <Fonts/FreeSans9pt8b.h>
-#include <Fonts/FreeSansBold12pt8b.h>
-#include <Fonts/FreeSansBold18pt8b.h>
-#include <Fonts/FreeSansBold24pt8b.h>
-#include <Fonts/FreeSansBold9pt8b.h>
-#include <Fonts/FreeSansBoldOblique12pt8b.h>
-#include <Fonts/FreeSansBoldOblique18pt8b.h>
-#include <Fonts/FreeSansBoldOblique24pt8b.h>
-#include <Fonts/FreeSansBoldOblique9pt8b.h>
-#include <Fonts/FreeSansOblique9pt8b.h>
-
 #include "esp32-hal-log.h"
 #include "esp_log.h"
+#include <algorithm>
 
 // ------------------ General ------------------
-enum TXTState_NEW { TXT_, FONT, SAVE_AS, LOAD_FILE, JOURNAL_MODE, NEW_FILE };
+enum TXTState_NEW { TXT_, FONT, SAVE_AS, LOAD_FILE, JOURNAL_MODE, NEW_FILE, OUTLINE };
 TXTState_NEW CurrentTXTState_NEW = TXT_;
+TXTState_NEW pickerReturnState = TXT_;  // State to return to when leaving the outline/font picker
 
 #define TYPE_INTERFACE_TIMEOUT 5000  // ms
 #define SCROLL_LINE_OFFSET 3         // lines
@@ -65,44 +30,60 @@ TXTState_NEW CurrentTXTState_NEW = TXT_;
 #define HEADING_LINE_PADDING 8  // Padding between each line
 #define NORMAL_LINE_PADDING 2
 
+#define PRERENDER_IDLE_MS 1000   // ms without edits before adjacent pages are pre-rendered
+#define PRERENDER_STEP 8         // lines, longest pre-render offset (one full slider swipe)
+#define LAYOUT_CHUNK_LINES 16    // DocLines reflowed per chunk by the layout worker
+#define RENDER_CHUNK_LINES 8     // DocLines copied per docMutex hold while a page is drawn
+
 enum FontFamily { serif = 0, sans = 1, mono = 2 };
 uint8_t fontStyle = sans;
 
+// A face from the card's font packs, or the built-in stand-in when the card does not have it
+struct FontRef {
+  int pack = -1;
+  const GFXfont* builtin = nullptr;
+};
+
+const GFXfont* resolveFont(const FontRef& ref) {
+  const GFXfont* font = ref.pack >= 0 ? FONTS().use(ref.pack) : nullptr;
+  return font ? font : ref.builtin;
+}
+
 struct FontMap {
-  const GFXfont* normal;
-  const GFXfont* normal_B;
-  const GFXfont* normal_I;
-  const GFXfont* normal_BI;
-
-  const GFXfont* h1;
-  const GFXfont* h1_B;
-  const GFXfont* h1_I;
-  const GFXfont* h1_BI;
-
-  const GFXfont* h2;
-  const GFXfont* h2_B;
-  const GFXfont* h2_I;
-  const GFXfont* h2_BI;
-
-  const GFXfont* h3;
-  const GFXfont* h3_B;
-  const GFXfont* h3_I;
-  const GFXfont* h3_BI;
-
-  const GFXfont* code;
-  const GFXfont* code_B;
-  const GFXfont* code_I;
-  const GFXfont* code_BI;
-
-  const GFXfont* quote;
-  const GFXfont* quote_B;
-  const GFXfont* quote_I;
-  const GFXfont* quote_BI;
-
-  const GFXfont* list;
-  const GFXfont* list_B;
-  const GFXfont* list_I;
-  const GFXfont* list_BI;
+  FontRef normal;
+  FontRef normal_B;
+  FontRef normal_I;
+  FontRef normal_BI;
+
+  FontRef h1;
+  FontRef h1_B;
+  FontRef h1_I;
+  FontRef h1_BI;
+
+  FontRef h2;
+  FontRef h2_B;
+  FontRef h2_I;
+  FontRef h2_BI;
+
+  FontRef h3;
+  FontRef h3_B;
+  FontRef h3_I;
+  FontRef h3_BI;
+
+  FontRef code;
+  FontRef code_B;
+  FontRef code_I;
+  FontRef code_BI;
+
+  FontRef quote;
+  FontRef quote_B;
+  FontRef quote_I;
+  FontRef quote_BI;
+
+  FontRef list;
+  FontRef list_B;
+  FontRef list_I;
+  FontRef list_BI;
 };
 
 FontMap fonts[3];
@@ -111,83 +92,118 @@ void setFontStyle(FontFamily f) {
   fontStyle = f;
 }
 
-const GFXfont* pickFont(char style, bool bold, bool italic) {
-  FontMap& fm = fonts[fontStyle];  // currently active family
+const GFXfont* pickFontFamily(uint8_t family, char style, bool bold, bool italic) {
+  FontMap& fm = fonts[family];
 
   switch (style) {
     case '1':  // H1
       if (bold && italic)
-        return fm.h1_BI;
+        return resolveFont(fm.h1_BI);
       if (bold)
-        return fm.h1_B;
+        return resolveFont(fm.h1_B);
       if (italic)
-        return fm.h1_I;
-      return fm.h1;
+        return resolveFont(fm.h1_I);
+      return resolveFont(fm.h1);
 
     case '2':  // H2
       if (bold && italic)
-        return fm.h2_BI;
+        return resolveFont(fm.h2_BI);
       if (bold)
-        return fm.h2_B;
+        return resolveFont(fm.h2_B);
       if (italic)
-        return fm.h2_I;
-      return fm.h2;
+        return resolveFont(fm.h2_I);
+      return resolveFont(fm.h2);
 
     case '3':  // H3
       if (bold && italic)
-        return fm.h3_BI;
+        return resolveFont(fm.h3_BI);
       if (bold)
-        return fm.h3_B;
+        return resolveFont(fm.h3_B);
       if (italic)
-        return fm.h3_I;
-      return fm.h3;
+        return resolveFont(fm.h3_I);
+      return resolveFont(fm.h3);
 
     case '>':  // Quote
       if (bold && italic)
-        return fm.quote_BI;
+        return resolveFont(fm.quote_BI);
       if (bold)
-        return fm.quote_B;
+        return resolveFont(fm.quote_B);
       if (italic)
-        return fm.quote_I;
-      return fm.quote;
+        return resolveFont(fm.quote_I);
+      return resolveFont(fm.quote);
 
     case '-':  // List
       if (bold && italic)
-        return fm.list_BI;
+        return resolveFont(fm.list_BI);
       if (bold)
-        return fm.list_B;
+        return resolveFont(fm.list_B);
       if (italic)
-        return fm.list_I;
-      return fm.list;
+        return resolveFont(fm.list_I);
+      return resolveFont(fm.list);
 
     case 'C':  // Code
       if (bold && italic)
-        return fm.code_BI;
+        return resolveFont(fm.code_BI);
       if (bold)
-        return fm.code_B;
+        return resolveFont(fm.code_B);
       if (italic)
-        return fm.code_I;
-      return fm.code;
+        return resolveFont(fm.code_I);
+      return resolveFont(fm.code);
 
     default:  // Normal
       if (bold && italic)
-        return fm.normal_BI;
+        return resolveFont(fm.normal_BI);
       if (bold)
-        return fm.normal_B;
+        return resolveFont(fm.normal_B);
       if (italic)
-        return fm.normal_I;
-      return fm.normal;
+        return resolveFont(fm.normal_I);
+      return resolveFont(fm.normal);
   }
 }
 
+const GFXfont* pickFont(char style, bool bold, bool italic) {
+  return pickFontFamily(fontStyle, style, bold, italic);  // currently active family
+}
+
 // ------------------ Document Variables ------------------
-static bool updateScreen = false;
+static RedrawFlag updateScreen;
 ulong indexCounter = 0;
 ulong lineScroll = 0;
+volatile ulong docRevision = 0;       // Bumped on every change that affects the rendered page
+volatile ulong lastDocEditMillis = 0;
+String openDocPath = "";  // Note currently held in docLines
+bool docDirty = false;    // docLines has edits that are not saved yet
+uint32_t openDocSize = 0;   // sourceStamp() of openDocPath when docLines was loaded or saved
+uint32_t openDocWrite = 0;
 enum EditingModes { edit_inline = 0, edit_append = 1 };
 uint8_t currentEditMode = edit_append;
 String currentLine = "";
 
+// Drop any pre-rendered pages and hold off pre-rendering until editing pauses
+void invalidatePrerender() {
+  docRevision++;
+  lastDocEditMillis = millis();
+}
+
+// docLines is shared between input (core 1), the e-ink task and the layout worker (core 0)
+SemaphoreHandle_t docMutex = NULL;
+
+void lockDoc() {
+  if (docMutex)
+    xSemaphoreTakeRecursive(docMutex, portMAX_DELAY);
+}
+
+void unlockDoc() {
+  if (docMutex)
+    xSemaphoreGiveRecursive(docMutex);
+}
+
+// Holds docMutex for the rest of the scope
+struct DocLock {
+  DocLock() { lockDoc(); }
+  ~DocLock() { unlockDoc(); }
+};
+
 struct wordObject {
   String text;
   bool bold;
@@ -199,6 +215,63 @@ struct LineObject {
   std::vector<wordObject> words;
 };
 
+// Text measured on the input core uses its own font state, the display belongs to the e-ink task
+Adafruit_GFX& inputMeasure() {
+  static GFXcanvas1 measure(display.width(), 1);
+  return measure;
+}
+
+// Wrap words into display lines for a font family, measuring with gfx
+std::vector<LineObject> wrapWords(Adafruit_GFX& gfx, uint8_t family, char style,
+                                  const std::vector<wordObject>& words) {
+  uint16_t textWidth = gfx.width() - DISPLAY_WIDTH_BUFFER;
+
+  if (style == '>' || style == 'C') {
+    textWidth -= SPECIAL_PADDING;
+  }
+  else if (style == '-' || style == 'L') {
+    textWidth -= 2*SPECIAL_PADDING;
+  }
+
+  std::vector<LineObject> lines;
+  LineObject currentLine;
+  currentLine.index = 0;
+  int lineWidth = 0;
+
+  for (auto& w : words) {
+    const GFXfont* font = pickFontFamily(family, style, w.bold, w.italic);
+    gfx.setFont(font);
+
+    int16_t x1, y1;
+    uint16_t wpx, hpx;
+    gfx.getTextBounds(GlyphText(w.text).c_str(), 0, 0, &x1, &y1, &wpx, &hpx);
+
+    uint16_t spaceWidth;
+    gfx.getTextBounds(SPACEWIDTH_SYMBOL, 0, 0, &x1, &y1, &spaceWidth, &hpx);
+
+    // Calculate width for this word plus space
+    int addWidth =
+        wpx + spaceWidth + WORDWIDTH_BUFFER;  // IDK why 12 makes the text wrap work perfectly...
+
+    // If the word doesn't fit, start a new line
+    if (lineWidth > 0 && (lineWidth + addWidth > textWidth)) {
+      lines.push_back(currentLine);
+
+      currentLine.words.clear();
+      lineWidth = 0;
+    }
+
+    currentLine.words.push_back(w);
+    lineWidth += addWidth;
+  }
+
+  if (!currentLine.words.empty()) {
+    lines.push_back(currentLine);
+  }
+
+  return lines;
+}
+
 // Document Line object
 struct DocLine {
   char style;                     // Markdown style: '1', '2', '3', '>', '-', etc.
@@ -206,6 +279,7 @@ struct DocLine {
   std::vector<wordObject> words;  // Parsed words with formatting
   std::vector<LineObject> lines;  // split into line objects
   ulong orderedListNumber;
+  uint8_t layoutFamily;  // Font family the lines were wrapped for
 
   // Parse the line into wordObjects
   void parseWords() {
@@ -246,51 +320,18 @@ struct DocLine {
 
   // Split word objects into lines
   void splitToLines() {
-    uint16_t textWidth = display.width() - DISPLAY_WIDTH_BUFFER;
-
-    if (style == '>' || style == 'C') {
-      textWidth -= SPECIAL_PADDING;
-    }
-    else if (style == '-' || style == 'L') {
-      textWidth -= 2*SPECIAL_PADDING;
-    }
-
-    lines.clear();
-    LineObject currentLine;
-    int lineWidth = 0;
-
-    for (auto& w : words) {
-      const GFXfont* font = pickFont(style, w.bold, w.italic);
-      display.setFont(font);
-
-      int16_t x1, y1;
-      uint16_t wpx, hpx;
-      display.getTextBounds(w.text.c_str(), 0, 0, &x1, &y1, &wpx, &hpx);
-
-      int spaceWidth;
-      display.getTextBounds(SPACEWIDTH_SYMBOL, 0, 0, &x1, &y1, (uint16_t*)&spaceWidth, &hpx);
-
-      // Calculate width for this word plus space
-      int addWidth =
-          wpx + spaceWidth + WORDWIDTH_BUFFER;  // IDK why 12 makes the text wrap work perfectly...
-
-      // If the word doesn't fit, start a new line
-      if (lineWidth > 0 && (lineWidth + addWidth > textWidth)) {
-        currentLine.index = indexCounter++;
-        lines.push_back(currentLine);
-
-        currentLine.words.clear();
-        lineWidth = 0;
-      }
-
-      currentLine.words.push_back(w);
-      lineWidth += addWidth;
-    }
+    lines = wrapWords(inputMeasure(), fontStyle, style, words);
+    for (auto& ln : lines)
+      ln.index = indexCounter++;
+    layoutFamily = fontStyle;
+  }
 
-    if (!currentLine.words.empty()) {
-      currentLine.index = indexCounter++;
-      lines.push_back(currentLine);
-    }
+  // Re-wrap for the current font, starting from the words as edited
+  void rewrap() {
+    words.clear();
+    for (const auto& ln : lines)
+      words.insert(words.end(), ln.words.begin(), ln.words.end());
+    splitToLines();
   }
 
   // Compile line objects back into text
@@ -324,12 +365,12 @@ struct DocLine {
     line = compiled;
   }
 
-  int displayLine(int startX, int startY) {
+  int displayLine(Adafruit_GFX& gfx, ulong scroll, int startX, int startY) {
     ulong offsetLineScroll = 0;
-    if (lineScroll <= SCROLL_LINE_OFFSET) {
+    if (scroll <= SCROLL_LINE_OFFSET) {
       offsetLineScroll = 0;
     } else
-      offsetLineScroll = lineScroll - SCROLL_LINE_OFFSET;
+      offsetLineScroll = scroll - SCROLL_LINE_OFFSET;
 
     int cursorY = startY;
 
@@ -342,8 +383,8 @@ struct DocLine {
 
     // Horizontal Rules just print a line
     if (style == 'H') {
-      display.drawFastHLine(0, cursorY + 3, display.width(), GxEPD_BLACK);
-      display.drawFastHLine(0, cursorY + 4, display.width(), GxEPD_BLACK);
+      gfx.drawFastHLine(0, cursorY + 3, gfx.width(), GxEPD_BLACK);
+      gfx.drawFastHLine(0, cursorY + 4, gfx.width(), GxEPD_BLACK);
       return 8;
     }
     // Blank lines just take up space
@@ -376,10 +417,10 @@ struct DocLine {
       uint16_t max_hpx = 0;
       for (auto& w : ln.words) {
         const GFXfont* font = pickFont(style, w.bold, w.italic);
-        display.setFont(font);
+        gfx.setFont(font);
         int16_t x1, y1;
         uint16_t wpx, hpx;
-        display.getTextBounds(w.text.c_str(), cursorX, cursorY, &x1, &y1, &wpx, &hpx);
+        gfx.getTextBounds(GlyphText(w.text).c_str(), cursorX, cursorY, &x1, &y1, &wpx, &hpx);
         if (hpx > max_hpx)
           max_hpx = hpx;
       }
@@ -391,20 +432,21 @@ struct DocLine {
       // 2. Draw all words at the same baseline
       for (auto& w : ln.words) {
         const GFXfont* font = pickFont(style, w.bold, w.italic);
-        display.setFont(font);
+        gfx.setFont(font);
 
+        GlyphText glyphs(w.text);
         int16_t x1, y1;
         uint16_t wpx, hpx;
-        display.getTextBounds(w.text.c_str(), cursorX, cursorY, &x1, &y1, &wpx, &hpx);
+        gfx.getTextBounds(glyphs.c_str(), cursorX, cursorY, &x1, &y1, &wpx, &hpx);
 
         // Draw word at the baseline
-        display.setCursor(cursorX, cursorY + max_hpx);
-        display.print(w.text);
+        gfx.setCursor(cursorX, cursorY + max_hpx);
+        gfx.print(glyphs.c_str());
 
         // Advance cursor (word width + space)
         int16_t sx1, sy1;
         uint16_t sw, sh;
-        display.getTextBounds(SPACEWIDTH_SYMBOL, cursorX, cursorY, &sx1, &sy1, &sw, &sh);
+        gfx.getTextBounds(SPACEWIDTH_SYMBOL, cursorX, cursorY, &sx1, &sy1, &sw, &sh);
 
         cursorX += wpx + sw;
       }
@@ -422,41 +464,41 @@ struct DocLine {
 
     // Blockquotes get a vertical line on the left
     if (style == '>') {
-      display.drawFastVLine(SPECIAL_PADDING / 2, startY, (cursorY - startY), GxEPD_BLACK);
-      display.drawFastVLine((SPECIAL_PADDING / 2) + 1, startY, (cursorY - startY), GxEPD_BLACK);
+      gfx.drawFastVLine(SPECIAL_PADDING / 2, startY, (cursorY - startY), GxEPD_BLACK);
+      gfx.drawFastVLine((SPECIAL_PADDING / 2) + 1, startY, (cursorY - startY), GxEPD_BLACK);
     }
 
     // Code Blocks get a vertical line on each side
     else if (style == 'C') {
-      display.drawFastVLine(SPECIAL_PADDING / 4, startY, (cursorY - startY), GxEPD_BLACK);
-      display.drawFastVLine(display.width() - (SPECIAL_PADDING / 4), startY, (cursorY - startY),
-                            GxEPD_BLACK);
-      display.drawFastVLine((SPECIAL_PADDING / 4) + 1, startY, (cursorY - startY), GxEPD_BLACK);
-      display.drawFastVLine(display.width() - (SPECIAL_PADDING / 4) - 1, startY, (cursorY - startY),
-                            GxEPD_BLACK);
+      gfx.drawFastVLine(SPECIAL_PADDING / 4, startY, (cursorY - startY), GxEPD_BLACK);
+      gfx.drawFastVLine(gfx.width() - (SPECIAL_PADDING / 4), startY, (cursorY - startY),
+                        GxEPD_BLACK);
+      gfx.drawFastVLine((SPECIAL_PADDING / 4) + 1, startY, (cursorY - startY), GxEPD_BLACK);
+      gfx.drawFastVLine(gfx.width() - (SPECIAL_PADDING / 4) - 1, startY, (cursorY - startY),
+                        GxEPD_BLACK);
     }
 
     // Headings get a horizontal line below them
     else if ((style == '1' || style == '2' || style == '3')) {
-      display.drawFastHLine(0, cursorY - 2, display.width(), GxEPD_BLACK);
-      display.drawFastHLine(0, cursorY - 3, display.width(), GxEPD_BLACK);
+      gfx.drawFastHLine(0, cursorY - 2, gfx.width(), GxEPD_BLACK);
+      gfx.drawFastHLine(0, cursorY - 3, gfx.width(), GxEPD_BLACK);
     }
 
     // Unordered Lists get a '●'
     else if (style == '-') {
-      display.fillCircle(startX - 8, startY + 8, 3, GxEPD_BLACK);
+      gfx.fillCircle(startX - 8, startY + 8, 3, GxEPD_BLACK);
     }
     // Ordered Lists get their #
     else if (style == 'L') {
       String number = String(orderedListNumber) + ". ";
       const GFXfont* font = pickFont('T', false, false);
-      display.setFont(font);
+      gfx.setFont(font);
       int16_t x1, y1;
       uint16_t wpx, hpx;
-      display.getTextBounds(number.c_str(), 0, 0, &x1, &y1, &wpx, &hpx);
+      gfx.getTextBounds(number.c_str(), 0, 0, &x1, &y1, &wpx, &hpx);
 
-      display.setCursor(startX - wpx - 5, startY + hpx);
-      display.print(number.c_str());
+      gfx.setCursor(startX - wpx - 5, startY + hpx);
+      gfx.print(number.c_str());
     }
 
     return cursorY - startY;
@@ -539,7 +581,7 @@ struct DocLine {
 
         int16_t x1, y1;
         uint16_t wpx, hpx;
-        display.getTextBounds(w.text.c_str(), cursorX, cursorY, &x1, &y1, &wpx, &hpx);
+        display.getTextBounds(GlyphText(w.text).c_str(), cursorX, cursorY, &x1, &y1, &wpx, &hpx);
 
         // Advance cursor (word width + space)
         int16_t sx1, sy1;
@@ -605,54 +647,389 @@ struct DocLine {
 ulong editingLine_index = 0;
 std::vector<DocLine> docLines;
 
+// ------------------ Outline ------------------
+
+// One entry per heading DocLine, kept sorted by docIndex
+struct OutlineEntry {
+  ulong docIndex;   // index into docLines
+  ulong lineIndex;  // LineObject index of the heading's first line (scroll target)
+  char style;       // '1', '2' or '3'
+  bool collapsed;   // hide everything up to the next heading of the same or higher level
+};
+
+std::vector<OutlineEntry> outline;
+int outlineSelection = 0;
+
+bool isHeadingStyle(char style) {
+  return style == '1' || style == '2' || style == '3';
+}
+
+// Find the first outline entry with docIndex >= docIdx
+size_t outlineLowerBound(ulong docIdx) {
+  size_t lo = 0, hi = outline.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (outline[mid].docIndex < docIdx)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+ulong firstLineIndex(const DocLine& doc) {
+  return doc.lines.empty() ? 0 : doc.lines.front().index;
+}
+
+// Rebuild the outline from scratch (file load)
+void rebuildOutline() {
+  outline.clear();
+  for (ulong i = 0; i < docLines.size(); i++) {
+    if (isHeadingStyle(docLines[i].style)) {
+      outline.push_back({i, firstLineIndex(docLines[i]), docLines[i].style, false});
+    }
+  }
+  outlineSelection = 0;
+}
+
+// A DocLine was inserted at docIdx, shift everything below it
+void outlineInsertDocLine(ulong docIdx) {
+  for (size_t o = outlineLowerBound(docIdx); o < outline.size(); o++) {
+    outline[o].docIndex++;
+  }
+}
+
+// The style of docIdx may have changed, add/update/remove its entry
+void outlineUpdateDocLine(ulong docIdx) {
+  if (docIdx >= docLines.size())
+    return;
+
+  const DocLine& doc = docLines[docIdx];
+  size_t o = outlineLowerBound(docIdx);
+  bool present = (o < outline.size() && outline[o].docIndex == docIdx);
+
+  if (isHeadingStyle(doc.style)) {
+    if (present)
+      outline[o].style = doc.style;
+    else
+      outline.insert(outline.begin() + o, {docIdx, firstLineIndex(doc), doc.style, false});
+  } else if (present) {
+    outline.erase(outline.begin() + o);
+  }
+}
+
+// Keep scroll targets in sync after LineObject indexes are renumbered
+void refreshOutlineLineIndexes() {
+  for (auto& entry : outline) {
+    if (entry.docIndex < docLines.size())
+      entry.lineIndex = firstLineIndex(docLines[entry.docIndex]);
+  }
+}
+
+// DocLine index where the section starting at outline[o] ends
+ulong outlineSectionEnd(size_t o) {
+  for (size_t n = o + 1; n < outline.size(); n++) {
+    if (outline[n].style <= outline[o].style)
+      return outline[n].docIndex;
+  }
+  return docLines.size();
+}
+
+// Returns the next DocLine to render after docIdx, skipping the body of a collapsed section.
+// cursor walks the outline alongside docIdx so a full document pass stays linear.
+ulong nextVisibleDocLine(ulong docIdx, size_t& cursor) {
+  while (cursor < outline.size() && outline[cursor].docIndex < docIdx) cursor++;
+
+  if (cursor < outline.size() && outline[cursor].docIndex == docIdx && outline[cursor].collapsed)
+    return outlineSectionEnd(cursor);
+
+  return docIdx + 1;
+}
+
+// Plain text of a DocLine as it is currently being edited
+String docLineText(const DocLine& doc) {
+  String text = "";
+  for (const auto& ln : doc.lines) {
+    for (const auto& w : ln.words) {
+      if (w.text.length() == 0)
+        continue;
+      if (text.length() > 0)
+        text += " ";
+      text += w.text;
+    }
+  }
+  return text;
+}
+
+// Expand any collapsed parents of outline[o] so a jump target is actually rendered
+void revealOutlineEntry(size_t o) {
+  char level = outline[o].style;
+  for (size_t p = o; p-- > 0;) {
+    if (outline[p].style < level) {
+      outline[p].collapsed = false;
+      level = outline[p].style;
+    }
+  }
+}
+
+// Expand every collapsed section whose body holds docIdx, false if none was collapsed
+bool revealDocLine(ulong docIdx) {
+  bool changed = false;
+  for (size_t o = 0; o < outline.size() && outline[o].docIndex < docIdx; o++) {
+    if (outline[o].collapsed && docIdx < outlineSectionEnd(o)) {
+      outline[o].collapsed = false;
+      changed = true;
+    }
+  }
+  if (changed)
+    invalidatePrerender();
+  return changed;
+}
+
+void jumpToOutlineEntry(size_t o) {
+  if (o >= outline.size())
+    return;
+
+  revealOutlineEntry(o);
+  invalidatePrerender();
+  lineScroll = outline[o].lineIndex;
+}
+
 // ------------------ Rendering ------------------
 
-// Count number of display lines
+// Count number of display lines outside collapsed sections, the range the slider scrolls over
 int getTotalDisplayLines() {
   int total = 0;
-  for (const auto& doc : docLines) {
-    total += doc.lines.size();
+  size_t outlineCursor = 0;
+  for (ulong i = 0; i < docLines.size(); i = nextVisibleDocLine(i, outlineCursor)) {
+    total += docLines[i].lines.size();
   }
   return total;
 }
 
-// Display the entire document
-int displayDocument(int startX = 0, int startY = 0) {
-  int cursorY = startY;
+// Position of line lineIndex among the lines outside collapsed sections. The slider scrolls in
+// these positions so it never steps through hidden lines; a hidden line gets the position of the
+// next shown one.
+ulong visibleLineRank(ulong lineIndex) {
+  ulong rank = 0;
+  size_t outlineCursor = 0;
+  for (ulong i = 0; i < docLines.size(); i = nextVisibleDocLine(i, outlineCursor)) {
+    for (const auto& ln : docLines[i].lines) {
+      if (ln.index >= lineIndex)
+        return rank;
+      rank++;
+    }
+  }
+  return rank;
+}
 
-  for (auto& doc : docLines) {
-    // Display this DocLine, offset by current cursorY
-    int heightUsed = doc.displayLine(startX, cursorY);
+// Line index of the shown line at position rank, the last one past the end
+ulong visibleLineIndex(ulong rank) {
+  ulong last = 0;
+  size_t outlineCursor = 0;
+  for (ulong i = 0; i < docLines.size(); i = nextVisibleDocLine(i, outlineCursor)) {
+    for (const auto& ln : docLines[i].lines) {
+      if (rank-- == 0)
+        return ln.index;
+      last = ln.index;
+    }
+  }
+  return last;
+}
 
-    // If the line is off the bottom of the screen, stop drawing
-    if (cursorY > display.height())
+// Copies the next visible DocLines that reach down to line firstShown, up to
+// RENDER_CHUNK_LINES of them, with a flag for each collapsed heading. next and cursor carry on
+// from one call to the next. Pages are drawn from these copies without holding docMutex, so
+// edits never wait for layout or glyph rendering.
+void copyPageChunk(ulong firstShown, ulong& next, size_t& cursor, std::vector<DocLine>& chunk,
+                   std::vector<bool>& collapsed) {
+  chunk.clear();
+  collapsed.clear();
+
+  DocLock lock;
+  while (next < docLines.size() && chunk.size() < RENDER_CHUNK_LINES) {
+    const ulong i = next;
+    next = nextVisibleDocLine(i, cursor);
+    // Entirely above the page
+    if (!docLines[i].lines.empty() && docLines[i].lines.back().index < firstShown)
+      continue;
+    size_t o = outlineLowerBound(i);
+    chunk.push_back(docLines[i]);
+    collapsed.push_back(o < outline.size() && outline[o].docIndex == i && outline[o].collapsed);
+  }
+}
+
+// Render the document as seen from a given scroll position. Call without docMutex held.
+int renderDocument(Adafruit_GFX& gfx, ulong scroll, int startX = 0, int startY = 0) {
+  const ulong firstShown = (scroll > SCROLL_LINE_OFFSET) ? scroll - SCROLL_LINE_OFFSET : 0;
+  int cursorY = startY;
+  ulong next = 0;
+  size_t outlineCursor = 0;
+  std::vector<DocLine> chunk;
+  std::vector<bool> collapsed;
+
+  bool full = false;
+  while (!full) {
+    copyPageChunk(firstShown, next, outlineCursor, chunk, collapsed);
+    if (chunk.empty())
       break;
 
-    cursorY += heightUsed;
+    for (size_t k = 0; k < chunk.size(); k++) {
+      // Display this DocLine, offset by current cursorY
+      int heightUsed = chunk[k].displayLine(gfx, scroll, startX, cursorY);
+
+      // If the line is off the bottom of the screen, stop drawing
+      if (cursorY > gfx.height()) {
+        full = true;
+        break;
+      }
+
+      // Collapsed headings get a marker on the right
+      if (heightUsed > 0 && collapsed[k]) {
+        int midY = cursorY + heightUsed / 2;
+        gfx.fillTriangle(gfx.width() - 12, midY - 5, gfx.width() - 12, midY + 5, gfx.width() - 4,
+                         midY, GxEPD_BLACK);
+      }
+
+      cursorY += heightUsed;
+    }
   }
 
   // Return total height used
   return cursorY - startY;
 }
 
+// Display the entire document
+int displayDocument(int startX = 0, int startY = 0) {
+  return renderDocument(display, lineScroll, startX, startY);
+}
+
 int displayDocumentPreview(int startX = 0, int startY = 0) {
   int cursorY = startY;
+  ulong next = 0;
+  size_t outlineCursor = 0;
+  std::vector<DocLine> chunk;
+  std::vector<bool> collapsed;
+
+  bool full = false;
+  while (!full) {
+    copyPageChunk(lineScroll, next, outlineCursor, chunk, collapsed);
+    if (chunk.empty())
+      break;
 
-  for (auto& doc : docLines) {
-    // Display this DocLine, offset by current cursorY
-    int heightUsed = doc.displayLinePreview(startX, cursorY);
+    for (auto& doc : chunk) {
+      // Display this DocLine, offset by current cursorY
+      int heightUsed = doc.displayLinePreview(startX, cursorY);
 
-    // If the line is off the bottom of the screen, stop drawing
-    if (cursorY > u8g2.getDisplayHeight())
-      break;
+      // If the line is off the bottom of the screen, stop drawing
+      if (cursorY > u8g2.getDisplayHeight()) {
+        full = true;
+        break;
+      }
 
-    cursorY += heightUsed;
+      cursorY += heightUsed;
+    }
   }
 
   // Return total height used
   return cursorY - startY;
 }
 
+// ------------------ Pre-render ------------------
+// While idle, the pages one swipe above and below the screen are rendered off-screen on core 0
+// so a slider scroll only has to copy a finished page into the e-ink page.
+struct PrerenderedPage {
+  EinkCanvas* canvas;
+  ulong scroll;
+  ulong revision;
+  uint8_t family;
+  bool valid;
+};
+
+PrerenderedPage prerenderAbove = {nullptr, 0, 0, serif, false};
+PrerenderedPage prerenderBelow = {nullptr, 0, 0, serif, false};
+ulong prerenderBase = 0;  // lineScroll of the page currently on the e-ink
+ulong prerenderStep = PRERENDER_STEP;
+
+bool prerenderIsCurrent(const PrerenderedPage& page, ulong scroll) {
+  return page.valid && page.scroll == scroll && page.revision == docRevision &&
+         page.family == fontStyle;
+}
+
+// Returns true if the page had to be rendered
+bool prerenderPage(PrerenderedPage& page, ulong scroll) {
+  if (prerenderIsCurrent(page, scroll))
+    return false;
+
+  if (!page.canvas) {
+    page.canvas = new EinkCanvas();
+    if (!page.canvas->getBuffer()) {
+      ESP_LOGE(TAG, "No memory for pre-render buffer");
+      delete page.canvas;
+      page.canvas = nullptr;
+      return false;
+    }
+  }
+
+  page.valid = false;
+  page.canvas->fillScreen(GxEPD_WHITE);
+  ulong revision;
+  {
+    DocLock lock;
+    revision = docRevision;
+  }
+  renderDocument(*page.canvas, scroll);
+
+  page.scroll = scroll;
+  page.revision = revision;
+  page.family = fontStyle;
+  // An edit on core 1 during the render leaves the page stale
+  page.valid = (revision == docRevision);
+  return true;
+}
+
+void prerenderAdjacentPages() {
+  if (CurrentTXTState_NEW != TXT_ && CurrentTXTState_NEW != JOURNAL_MODE)
+    return;
+  // Slider in use or still typing, look again later
+  if (TOUCH().getLastTouch() != -1 || millis() - lastDocEditMillis < PRERENDER_IDLE_MS) {
+    EINK().requestRedraw(REDRAW_IDLE);
+    return;
+  }
+
+  // One swipe of prerenderStep shown lines away, the way the slider moves
+  ulong above;
+  ulong below;
+  {
+    // docLines may be reallocated by core 1 or the layout worker while it is walked
+    DocLock lock;
+    const ulong base = visibleLineRank(prerenderBase);
+    above = visibleLineIndex((base > prerenderStep) ? base - prerenderStep : 0);
+    below = visibleLineIndex(min(base + prerenderStep, (ulong)getTotalDisplayLines()));
+  }
+
+  // At most one page per call so a pending refresh is never held up for long
+  if (above != prerenderBase && prerenderPage(prerenderAbove, above)) {
+    EINK().requestRedraw(REDRAW_IDLE);
+    return;
+  }
+  if (below != prerenderBase)
+    prerenderPage(prerenderBelow, below);
+}
+
+// Copy a pre-rendered page into target, false if none matches
+bool commitPrerenderedPage(ulong scroll, EinkCanvas& target) {
+  PrerenderedPage* pages[] = {&prerenderAbove, &prerenderBelow};
+  for (PrerenderedPage* page : pages) {
+    if (prerenderIsCurrent(*page, scroll)) {
+      target.copyFrom(*page->canvas);
+      return true;
+    }
+  }
+  return false;
+}
+
+
 bool lineHasText(const LineObject& lineObj) {
   // Check if line has any words
   if (lineObj.words.empty())
@@ -688,7 +1065,11 @@ void toolBar(wordObject& wordObj) {
   }
 
   // Show line type
-  char currentDocLineType = docLines[editingLine_index].style;
+  char currentDocLineType;
+  {
+    DocLock lock;
+    currentDocLineType = docLines[editingLine_index].style;
+  }
   String lineTypeLabel;
 
   switch (currentDocLineType) {
@@ -796,7 +1177,7 @@ int getLineWidthOLED(const LineObject& lineObj) {
   for (const auto& w : lineObj.words) {
     setFontOLED(w.bold, w.italic);
 
-    uint16_t wpx = u8g2.getStrWidth(w.text.c_str());
+    uint16_t wpx = u8g2.getUTF8Width(w.text.c_str());
 
     int spaceWidth = u8g2.getStrWidth(" " /*SPACEWIDTH_SYMBOL*/);
 
@@ -814,14 +1195,21 @@ void scrollPreview() {
 
   uint16_t xInit = u8g2.getDisplayWidth() / 3;
 
-  LineObject* scrollLinePtr = getLineObjectByIndex(lineScroll);
-  if (!scrollLinePtr) {
-    // Pointer invalid, nothing to display
-    return;
+  LineObject scrollLine;
+  char style;
+  ulong scroll;
+  {
+    DocLock lock;
+    scroll = lineScroll;
+    LineObject* scrollLinePtr = getLineObjectByIndex(scroll);
+    if (!scrollLinePtr) {
+      // Pointer invalid, nothing to display
+      return;
+    }
+    scrollLine = *scrollLinePtr;
+    style = getStyleFromScrollLine(scroll);
   }
 
-  LineObject scrollLine = *getLineObjectByIndex(lineScroll);
-
   if (&scrollLine) {
     // Display Line
 
@@ -831,9 +1219,9 @@ void scrollPreview() {
     for (size_t i = 0; i < scrollLine.words.size(); ++i) {
       const auto& w = scrollLine.words[i];
       setFontOLED(w.bold, w.italic);
-      u8g2.drawStr(xpos, 20, w.text.c_str());
+      u8g2.drawUTF8(xpos, 20, w.text.c_str());
 
-      uint16_t wpx = u8g2.getStrWidth(w.text.c_str());
+      uint16_t wpx = u8g2.getUTF8Width(w.text.c_str());
 
       // Only add space if not the last word
       if (i < scrollLine.words.size() - 1) {
@@ -845,7 +1233,6 @@ void scrollPreview() {
     }
 
     // Draw line number and type
-    char style = getStyleFromScrollLine(lineScroll);
     String lineTypeLabel = "";
 
     switch (style) {
@@ -884,7 +1271,7 @@ void scrollPreview() {
         break;
     }
 
-    String lineInfoStr = "L:" + String(lineScroll) + "-" + lineTypeLabel;
+    String lineInfoStr = "L:" + String(scroll) + "-" + lineTypeLabel;
 
     u8g2.setFont(u8g2_font_5x7_tf);
     u8g2.drawStr(xInit, u8g2.getDisplayHeight(), lineInfoStr.c_str());
@@ -902,7 +1289,7 @@ void scrollPreview() {
   } else {
     return;
   }
-  u8g2.sendBuffer();
+  OLED().sendBuffer();
 }
 
 void oledEditorDisplay(LineObject& lineObj, wordObject& currentWord, int pixelsUsed,
@@ -917,9 +1304,9 @@ void oledEditorDisplay(LineObject& lineObj, wordObject& currentWord, int pixelsU
     for (size_t i = 0; i < lineObj.words.size(); ++i) {
       const auto& w = lineObj.words[i];
       setFontOLED(w.bold, w.italic);
-      u8g2.drawStr(xpos, 20, w.text.c_str());
+      u8g2.drawUTF8(xpos, 20, w.text.c_str());
 
-      uint16_t wpx = u8g2.getStrWidth(w.text.c_str());
+      uint16_t wpx = u8g2.getUTF8Width(w.text.c_str());
 
       // Only add space if not the last word
       if (i < lineObj.words.size() - 1) {
@@ -940,7 +1327,7 @@ void oledEditorDisplay(LineObject& lineObj, wordObject& currentWord, int pixelsU
       const auto& w = lineObj.words[lineObj.words.size() - 1 - i];
       setFontOLED(w.bold, w.italic);
 
-      uint16_t wpx = u8g2.getStrWidth(w.text.c_str());
+      uint16_t wpx = u8g2.getUTF8Width(w.text.c_str());
 
       // Subtract spacing *only if not the rightmost word*
       if (i == 0) {
@@ -952,7 +1339,7 @@ void oledEditorDisplay(LineObject& lineObj, wordObject& currentWord, int pixelsU
 
       // Draw word if it's on the screen
       if ((xpos + wpx) > 0) {
-        u8g2.drawStr(xpos, 20, w.text.c_str());
+        u8g2.drawUTF8(xpos, 20, w.text.c_str());
       }
     }
 
@@ -1010,7 +1397,110 @@ void oledEditorDisplay(LineObject& lineObj, wordObject& currentWord, int pixelsU
     OLED().infoBar();
   }
 
-  u8g2.sendBuffer();
+  OLED().sendBuffer();
+}
+
+// Outline picker on the OLED: selected heading and its position
+void outlinePickerOLED() {
+  OutlineEntry entry;
+  String title;
+  size_t count;
+  {
+    DocLock lock;
+    count = outline.size();
+    if (outlineSelection < (int)count) {
+      entry = outline[outlineSelection];
+      title = docLineText(docLines[entry.docIndex]);
+    }
+  }
+
+  u8g2.clearBuffer();
+
+  if (outlineSelection < (int)count) {
+    if (entry.collapsed)
+      title = "+ " + title;
+
+    u8g2.setFont(u8g2_font_ncenB14_tr);
+    int indent = (entry.style - '1') * 12;
+    u8g2.drawUTF8(indent, 18, title.c_str());
+
+    u8g2.setFont(u8g2_font_5x7_tf);
+    String info = "H" + String(entry.style) + "  " + String(outlineSelection + 1) + "/" +
+                  String(count);
+    u8g2.drawStr(0, u8g2.getDisplayHeight(), info.c_str());
+    u8g2.drawStr(u8g2.getDisplayWidth() - u8g2.getStrWidth("Tab:Fold Sel:Jump"),
+                 u8g2.getDisplayHeight(), "Tab:Fold Sel:Jump");
+  }
+
+  OLED().sendBuffer();
+}
+
+// Outline picker on the e-ink: one heading per row, indented by level
+void drawOutlinePicker() {
+  const int rowHeight = 18;
+  const int maxRows = (display.height() - 26) / rowHeight;
+
+  // Keep the selection on screen
+  int first = 0;
+  if (outlineSelection >= maxRows)
+    first = outlineSelection - maxRows + 1;
+
+  display.setFont(resolveFont(fonts[serif].normal));
+  display.setTextColor(GxEPD_BLACK);
+
+  for (int row = 0; row < maxRows && first + row < (int)outline.size(); row++) {
+    const OutlineEntry& entry = outline[first + row];
+    int y = row * rowHeight;
+    int x = 16 + (entry.style - '1') * 16;
+
+    if (first + row == outlineSelection) {
+      display.fillRect(0, y, display.width(), rowHeight, GxEPD_BLACK);
+      display.setTextColor(GxEPD_WHITE);
+    }
+
+    display.setCursor(4, y + 13);
+    display.print(entry.collapsed ? "+" : "-");
+    display.setCursor(x, y + 13);
+    display.print(GlyphText(docLineText(docLines[entry.docIndex])).c_str());
+
+    display.setTextColor(GxEPD_BLACK);
+  }
+
+  EINK().drawStatusBar("Outline: " + String(outline.size()) + " Headings");
+}
+
+// Font picker on the OLED
+void fontPickerOLED() {
+  u8g2.clearBuffer();
+  u8g2.setFont(u8g2_font_ncenB14_tr);
+  u8g2.drawStr(0, 18, "1:Serif 2:Sans 3:Mono");
+  u8g2.setFont(u8g2_font_5x7_tf);
+  u8g2.drawStr(u8g2.getDisplayWidth() - u8g2.getStrWidth("Bksp:Cancel"),
+               u8g2.getDisplayHeight(), "Bksp:Cancel");
+  OLED().sendBuffer();
+}
+
+// Font picker on the e-ink: a sample of each family, the active one boxed
+void drawFontPicker() {
+  static const char* names[] = {"Serif", "Sans", "Mono"};
+  const int rowHeight = 60;
+
+  display.setTextColor(GxEPD_BLACK);
+  for (int f = 0; f < 3; f++) {
+    int y = 8 + f * rowHeight;
+    if (f == fontStyle)
+      display.drawRect(4, y, display.width() - 8, rowHeight - 8, GxEPD_BLACK);
+
+    display.setFont(resolveFont(fonts[f].h2));
+    display.setCursor(12, y + 24);
+    display.print(String(f + 1) + ". " + names[f]);
+
+    display.setFont(resolveFont(fonts[f].normal));
+    display.setCursor(12, y + 44);
+    display.print("The quick brown fox");
+  }
+
+  EINK().drawStatusBar("Select a Font (1-3)");
 }
 
 // ------------------ Document ------------------
@@ -1052,54 +1542,274 @@ void refreshAllLineIndexes() {
 
   // Update list indexes
   refreshOrderedListIndexes();
+
+  // Update outline scroll targets
+  refreshOutlineLineIndexes();
 }
 
-// Load File
-void loadMarkdownFile(const String& path) {
-  // Invalid file
-  if (path == "" || path == " " || path == "-") {
-    OLED().oledWord("No file saved! Creating blank file.");
-    delay(2000);
+// ------------------ Layout Worker ------------------
+// Font changes reflow the document on core 0 in chunks of LAYOUT_CHUNK_LINES DocLines, starting
+// at the view. A chunk is wrapped without holding docMutex and published under it, skipping any
+// line edited in the meantime. The line being edited is always wrapped on core 1 first.
+struct LayoutJob {
+  uint8_t family;
+  ulong anchorDoc;  // DocLine at the top of the view
+};
 
-    // Create an empty new docLines object
-    docLines.push_back({'T', "", {}});
-    editingLine_index = 0;
+struct LayoutSlot {
+  ulong docIndex;
+  char style;
+  std::vector<wordObject> words;
+  std::vector<LineObject> lines;
+};
 
-    // Populate and update as usual so UI doesn’t crash
-    populateLines(docLines);
-    refreshAllLineIndexes();
+QueueHandle_t layoutQueue = NULL;
+TaskHandle_t layoutWorkerHandle = NULL;
 
-    if (SAVE_POWER)
-      pocketmage::setCpuSpeed(80);
-    SDActive = false;
-    return;
-  }
+void flattenWords(const DocLine& dl, std::vector<wordObject>& out) {
+  out.clear();
+  for (const auto& ln : dl.lines)
+    out.insert(out.end(), ln.words.begin(), ln.words.end());
+}
 
-  if (SD().getNoSD()) {
-    OLED().oledWord("LOAD FAILED - No SD!");
-    delay(5000);
-    return;
+bool sameWords(const DocLine& dl, const std::vector<wordObject>& words) {
+  size_t k = 0;
+  for (const auto& ln : dl.lines) {
+    for (const auto& w : ln.words) {
+      if (k >= words.size())
+        return false;
+      const wordObject& o = words[k++];
+      if (o.bold != w.bold || o.italic != w.italic || o.text != w.text)
+        return false;
+    }
   }
+  return k == words.size();
+}
 
-  SDActive = true;
-  pocketmage::setCpuSpeed(240);
-  delay(50);
-
-  docLines.clear();
-  File file = SD_MMC.open(path.c_str(), FILE_READ);
-  if (!file) {
-    ESP_LOGE("SD", "File does not exist: %s", path.c_str());  // FIXME: - Come up with better error handling
-                                                              //        - Should this be Error or Warning?
-    OLED().oledWord("LOAD FAILED - FILE MISSING");
-    delay(2000);
+void reflowDocument(const LayoutJob& job) {
+  // Private font state for measuring, the display belongs to the e-ink task
+  GFXcanvas1 measure(display.width(), 1);
+
+  ulong visited = 0;
+  ulong count;
+  ulong start;
+  ulong shownScroll;
+  bool shown = false;
+  {
+    DocLock lock;
+    count = docLines.size();
+    start = count ? min(job.anchorDoc, count - 1) : 0;
+    shownScroll = lineScroll;
+  }
+
+  while (visited < count) {
+    // A newer job supersedes this one
+    if (uxQueueMessagesWaiting(layoutQueue) > 0)
+      return;
 
-    // Create an empty new docLines object
-    docLines.push_back({'T', "", {}});
-    editingLine_index = 0;
+    std::vector<LayoutSlot> chunk;
+    {
+      DocLock lock;
+      if (fontStyle != job.family)
+        return;
+      count = docLines.size();
+      while (visited < count && chunk.size() < LAYOUT_CHUNK_LINES) {
+        ulong i = (start + visited) % count;
+        visited++;
+        const DocLine& dl = docLines[i];
+        if (dl.layoutFamily == job.family)
+          continue;
+        LayoutSlot slot;
+        slot.docIndex = i;
+        slot.style = dl.style;
+        flattenWords(dl, slot.words);
+        chunk.push_back(std::move(slot));
+      }
+    }
+    if (chunk.empty())
+      continue;
+
+    for (auto& slot : chunk)
+      slot.lines = wrapWords(measure, job.family, slot.style, slot.words);
+
+    {
+      DocLock lock;
+      if (fontStyle != job.family)
+        return;
+      for (auto& slot : chunk) {
+        if (slot.docIndex >= docLines.size())
+          continue;
+        DocLine& dl = docLines[slot.docIndex];
+        if (dl.layoutFamily == job.family || !sameWords(dl, slot.words))
+          continue;
+        dl.words = std::move(slot.words);
+        dl.lines = std::move(slot.lines);
+        dl.layoutFamily = job.family;
+      }
+      refreshAllLineIndexes();
+
+      // Keep the same DocLine at the top of the view unless the user scrolled away
+      if (lineScroll == shownScroll && job.anchorDoc < docLines.size())
+        lineScroll = firstLineIndex(docLines[job.anchorDoc]);
+      invalidatePrerender();
+
+      // The first chunk covers the view, later ones only move lines above or below it
+      if (!shown || lineScroll != shownScroll)
+        updateScreen = true;
+      shown = true;
+      shownScroll = lineScroll;
+    }
+    vTaskDelay(1);
+  }
+}
+
+void layoutWorkerTask(void* parameter) {
+  LayoutJob job;
+  for (;;) {
+    if (xQueueReceive(layoutQueue, &job, portMAX_DELAY) == pdTRUE)
+      reflowDocument(job);
+  }
+}
+
+void initLayoutWorker() {
+  if (layoutWorkerHandle)
+    return;
+
+  docMutex = xSemaphoreCreateRecursiveMutex();
+  layoutQueue = xQueueCreate(1, sizeof(LayoutJob));
+  xTaskCreatePinnedToCore(
+    layoutWorkerTask,     // Function name
+    "layoutWorkerTask",   // Task name
+    8192,                 // Stack size
+    NULL,                 // Parameters
+    1,                    // Priority
+    &layoutWorkerHandle,  // Task handle
+    0                     // Core ID
+  );
+}
+
+// Queue a reflow of every line not wrapped for the current font family
+void requestReflow() {
+  if (!layoutQueue)
+    return;
+
+  DocLock lock;
+  LayoutJob job;
+  job.family = fontStyle;
+  job.anchorDoc = 0;
+  for (ulong i = 0; i < docLines.size(); i++) {
+    if (!docLines[i].lines.empty() && docLines[i].lines.back().index >= lineScroll) {
+      job.anchorDoc = i;
+      break;
+    }
+  }
+  xQueueOverwrite(layoutQueue, &job);
+}
+
+// Switch font family, returns false if it was already active
+bool changeFontFamily(uint8_t family) {
+  if (family == fontStyle)
+    return false;
+
+  DocLock lock;
+  setFontStyle((FontFamily)family);
+  invalidatePrerender();
+
+  // Typing continues on the current line straight away
+  if (editingLine_index < docLines.size())
+    docLines[editingLine_index].rewrap();
+  refreshAllLineIndexes();
+
+  requestReflow();
+  return true;
+}
+
+// Size and last write of the note on disk, a layout cache is only valid for the same stamp
+void sourceStamp(const String& path, uint32_t& size, uint32_t& lastWrite) {
+  size = 0;
+  lastWrite = 0;
+  File src = SD_MMC.open(path.c_str(), FILE_READ);
+  if (src) {
+    size = src.size();
+    lastWrite = (uint32_t)src.getLastWrite();
+    src.close();
+  }
+}
+
+// False if the note on disk is no longer the one a RAM or cached copy was made from
+bool sourceUnchanged(const String& path, uint32_t size, uint32_t lastWrite) {
+  uint32_t curSize, curWrite;
+  sourceStamp(path, curSize, curWrite);
+  return curSize == size && curWrite == lastWrite;
+}
+
+// Make freshly parsed lines the open note. They are parsed and wrapped beforehand, so docMutex
+// is only held for the swap.
+void publishDocLines(std::vector<DocLine>& lines, ulong editLine) {
+  DocLock lock;
+  docLines = std::move(lines);
+  editingLine_index = editLine;
+  refreshAllLineIndexes();
+  rebuildOutline();
+  invalidatePrerender();
+}
+
+// Load File
+void loadMarkdownFile(const String& path) {
+  {
+    DocLock lock;
+    invalidatePrerender();
+    lineScroll = 0;
+  }
+  std::vector<DocLine> lines;
+
+  // Invalid file
+  if (path == "" || path == " " || path == "-") {
+    OLED().oledWord("No file saved! Creating blank file.");
+    delay(2000);
+    openDocPath = "";
+    docDirty = false;
+
+    // Create an empty new docLines object
+    lines.push_back({'T', "", {}});
 
     // Populate and update as usual so UI doesn’t crash
-    populateLines(docLines);
-    refreshAllLineIndexes();
+    populateLines(lines);
+    publishDocLines(lines, 0);
+
+    if (SAVE_POWER)
+      pocketmage::setCpuSpeed(80);
+    SDActive = false;
+    return;
+  }
+
+  if (SD().getNoSD()) {
+    OLED().oledWord("LOAD FAILED - No SD!");
+    delay(5000);
+    return;
+  }
+
+  SDActive = true;
+  pocketmage::setCpuSpeed(240);
+  delay(50);
+
+  openDocPath = path;
+  docDirty = false;
+  File file = SD_MMC.open(path.c_str(), FILE_READ);
+  if (!file) {
+    ESP_LOGE("SD", "File does not exist: %s", path.c_str());  // FIXME: - Come up with better error handling
+                                                              //        - Should this be Error or Warning?
+    OLED().oledWord("LOAD FAILED - FILE MISSING");
+    delay(2000);
+
+    // Create an empty new docLines object
+    lines.push_back({'T', "", {}});
+    openDocSize = 0;
+    openDocWrite = 0;
+
+    // Populate and update as usual so UI doesn’t crash
+    populateLines(lines);
+    publishDocLines(lines, 0);
 
     if (SAVE_POWER)
       pocketmage::setCpuSpeed(80);
@@ -1149,33 +1859,77 @@ void loadMarkdownFile(const String& path) {
       content = line.substring(3); // remove "1. ", "2. ", etc.
     }
 
-    docLines.push_back({style, content, {}});
+    lines.push_back({style, content, {}});
   }
 
   file.close();
+  sourceStamp(path, openDocSize, openDocWrite);
 
-  if (docLines.empty()) {
-    docLines.push_back({'T', "", {}});
-    editingLine_index = 0;
-  } else {
-    editingLine_index = docLines.size() - 1;
-  }
+  if (lines.empty())
+    lines.push_back({'T', "", {}});
+  const ulong editLine = lines.size() - 1;
 
-  // Populate all the lines
-  populateLines(docLines);
-
-  // Update indexes
-  refreshAllLineIndexes();
+  // Populate all the lines, then swap them in
+  populateLines(lines);
+  publishDocLines(lines, editLine);
 
   if (SAVE_POWER)
     pocketmage::setCpuSpeed(80);
   SDActive = false;
 
-  OLED().oledWord("FILE LOADED");
-  delay(500);
+  OLED().toast("FILE LOADED", 500);
   fileLoaded = true;
 }
 
+// Each DocLine as a line of Markdown
+std::vector<String> compileMarkdown(std::vector<DocLine>& lines) {
+  std::vector<String> markdown;
+  markdown.reserve(lines.size());
+  for (auto &dl : lines) {
+    dl.compileToText();
+
+    String out;
+
+    switch (dl.style) {
+      case '1': out = "# " + dl.line; break;
+      case '2': out = "## " + dl.line; break;
+      case '3': out = "### " + dl.line; break;
+      case '>': out = "> " + dl.line; break;
+      case '-': out = "- " + dl.line; break;
+      case 'L': out = "1. " + dl.line; break; //String(dl.orderedListNumber) + ". " + dl.line; break;
+      case 'H': out = "---"; break;
+      case 'C': out = "```" + dl.line + "```"; break;
+      case 'B': out = ""; break;
+      default:  out = dl.line; break;
+    }
+
+    markdown.push_back(std::move(out));
+  }
+  return markdown;
+}
+
+// Write compiled lines to path along with its metadata, false if the file can't be opened
+bool writeMarkdownFile(const String& path, const std::vector<String>& markdown) {
+  File file = SD_MMC.open(path.c_str(), FILE_WRITE);
+  if (!file) {
+    ESP_LOGE("SD", "Failed to open file for writing: %s", path.c_str());
+    return false;
+  }
+
+  // Count stats on the way so the file is never read back
+  DocStatsCounter stats;
+  for (const auto& out : markdown) {
+    file.println(out);
+    stats.feedLine(out);
+  }
+
+  file.close();
+
+  // Save metadata
+  SD().writeMetadata(path, stats.finish());
+  return true;
+}
+
 void saveMarkdownFile(const String& path) {
   if (SD().getNoSD()) {
     OLED().oledWord("SAVE FAILED - No SD!");
@@ -1194,52 +1948,424 @@ void saveMarkdownFile(const String& path) {
   if (!savePath.startsWith("/"))
     savePath = "/" + savePath;
 
-  File file = SD_MMC.open(savePath.c_str(), FILE_WRITE);
-  if (!file) {
+  // Only compiling touches docLines, the card is written without docMutex
+  std::vector<String> markdown;
+  {
+    DocLock lock;
+    markdown = compileMarkdown(docLines);
+  }
+  if (!writeMarkdownFile(savePath, markdown)) {
     OLED().oledWord("SAVE FAILED - OPEN ERR");
     delay(2000);
-    ESP_LOGE("SD", "Failed to open file for writing: %s", savePath.c_str());
     SDActive = false;
     return;
   }
 
-  // Write each DocLine as Markdown
-  for (auto &dl : docLines) {
-    dl.compileToText();
+  SD().setEditingFile(savePath);
+  openDocPath = savePath;
+  docDirty = false;
+  sourceStamp(savePath, openDocSize, openDocWrite);
 
-    String out;
+  OLED().toast("Saved: " + savePath);
 
-    switch (dl.style) {
-      case '1': out = "# " + dl.line; break;
-      case '2': out = "## " + dl.line; break;
-      case '3': out = "### " + dl.line; break;
-      case '>': out = "> " + dl.line; break;
-      case '-': out = "- " + dl.line; break;
-      case 'L': out = "1. " + dl.line; break; //String(dl.orderedListNumber) + ". " + dl.line; break;
-      case 'H': out = "---"; break;
-      case 'C': out = "```" + dl.line + "```"; break;
-      case 'B': out = ""; break;
-      default:  out = dl.line; break;
+  if (SAVE_POWER)
+    pocketmage::setCpuSpeed(POWER_SAVE_FREQ);
+  SDActive = false;
+}
+
+// ------------------ Open Documents ------------------
+// Recently used notes stay parsed and laid out in RAM, most recently used first. Notes pushed
+// past the budget are saved and written to a layout cache on the SD card that skips parsing on
+// reopen. Both copies carry the note's sourceStamp() and are thrown away once the file changes.
+// Saving or losing a parked note's edits without the user asking is shown as an OLED toast.
+#define LAYOUT_CACHE_DIR "/sys/layout"
+#define LAYOUT_CACHE_MAGIC 0x324C4D50  // "PML2"
+
+struct OpenDocument {
+  String path;
+  std::vector<DocLine> docLines;
+  std::vector<OutlineEntry> outline;
+  ulong editingLine_index;
+  ulong lineScroll;
+  bool dirty;
+  size_t bytes;
+  uint32_t srcSize;   // sourceStamp() the copy was made from
+  uint32_t srcWrite;
+};
+
+std::vector<OpenDocument> openDocuments;
+
+size_t openDocumentBudget() {
+  return (psramFound() ? TXT_DOC_CACHE_PSRAM_KB : TXT_DOC_CACHE_KB) * 1024UL;
+}
+
+// Rough heap footprint of a parsed document
+size_t estimateDocumentBytes(const std::vector<DocLine>& lines) {
+  size_t bytes = lines.capacity() * sizeof(DocLine);
+  for (const auto& dl : lines) {
+    bytes += dl.line.length() + dl.words.capacity() * sizeof(wordObject);
+    for (const auto& w : dl.words)
+      bytes += w.text.length();
+    bytes += dl.lines.capacity() * sizeof(LineObject);
+    for (const auto& ln : dl.lines) {
+      bytes += ln.words.capacity() * sizeof(wordObject);
+      for (const auto& w : ln.words)
+        bytes += w.text.length();
     }
+  }
+  return bytes;
+}
 
-    file.println(out);
+String layoutCachePath(const String& path) {
+  // FNV-1a
+  uint32_t hash = 2166136261UL;
+  for (unsigned int i = 0; i < path.length(); i++) {
+    hash ^= (uint8_t)path[i];
+    hash *= 16777619UL;
+  }
+  char name[16];
+  snprintf(name, sizeof(name), "%08lx.pml", (unsigned long)hash);
+  return String(LAYOUT_CACHE_DIR) + "/" + name;
+}
+
+String noteName(const String& path) {
+  return path.substring(path.lastIndexOf('/') + 1);
+}
+
+// Unsaved edits of path are thrown away because the file changed on the card
+void reportLostEdits(const String& path) {
+  ESP_LOGW(TAG, "%s changed on disk, dropping unsaved edits", path.c_str());
+  OLED().toast("Edits lost: " + noteName(path) + " changed");
+}
+
+// Delete the least recently written layout caches until TXT_LAYOUT_CACHE_FILES remain
+void trimLayoutCaches() {
+  File dir = SD_MMC.open(LAYOUT_CACHE_DIR);
+  if (!dir)
+    return;
+
+  struct CacheFile {
+    time_t written;
+    String path;
+  };
+  std::vector<CacheFile> caches;
+  File file;
+  while ((file = dir.openNextFile())) {
+    if (!file.isDirectory())
+      caches.push_back({file.getLastWrite(), String(LAYOUT_CACHE_DIR) + "/" + file.name()});
+    file.close();
+  }
+  dir.close();
+
+  if (caches.size() <= TXT_LAYOUT_CACHE_FILES)
+    return;
+
+  std::sort(caches.begin(), caches.end(),
+            [](const CacheFile& a, const CacheFile& b) { return a.written < b.written; });
+  for (size_t i = 0; i < caches.size() - TXT_LAYOUT_CACHE_FILES; i++)
+    SD_MMC.remove(caches[i].path.c_str());
+}
+
+template <typename T>
+void writeLayoutValue(File& file, T value) {
+  file.write((const uint8_t*)&value, sizeof(T));
+}
+
+template <typename T>
+bool readLayoutValue(File& file, T& value) {
+  return file.read((uint8_t*)&value, sizeof(T)) == sizeof(T);
+}
+
+void writeLayoutCache(OpenDocument& doc) {
+  if (SD().getNoSD())
+    return;
+
+  File file = SD_MMC.open(layoutCachePath(doc.path).c_str(), FILE_WRITE);
+  if (!file) {
+    ESP_LOGW(TAG, "Layout cache write failed: %s", doc.path.c_str());
+    return;
+  }
+
+  writeLayoutValue<uint32_t>(file, LAYOUT_CACHE_MAGIC);
+  writeLayoutValue<uint8_t>(file, doc.dirty);
+  writeLayoutValue<uint32_t>(file, doc.srcSize);
+  writeLayoutValue<uint32_t>(file, doc.srcWrite);
+  writeLayoutValue<uint32_t>(file, doc.editingLine_index);
+  writeLayoutValue<uint32_t>(file, doc.lineScroll);
+  writeLayoutValue<uint32_t>(file, doc.docLines.size());
+
+  for (const auto& dl : doc.docLines) {
+    writeLayoutValue<uint8_t>(file, dl.style);
+    writeLayoutValue<uint8_t>(file, dl.layoutFamily);
+    writeLayoutValue<uint16_t>(file, dl.lines.size());
+    for (const auto& ln : dl.lines) {
+      writeLayoutValue<uint16_t>(file, ln.words.size());
+      for (const auto& w : ln.words) {
+        writeLayoutValue<uint8_t>(file, (w.bold ? 1 : 0) | (w.italic ? 2 : 0));
+        writeLayoutValue<uint16_t>(file, w.text.length());
+        file.write((const uint8_t*)w.text.c_str(), w.text.length());
+      }
+    }
   }
 
   file.close();
+  trimLayoutCaches();
+}
 
-  // Save metadata
-  SD().writeMetadata(savePath);
-  SD().setEditingFile(savePath);
+// Load a note from its layout cache into docLines, false if there is no valid cache
+bool loadLayoutCache(const String& path) {
+  if (SD().getNoSD())
+    return false;
 
-  OLED().oledWord("Saved: " + savePath);
-  delay(1000);
+  String cachePath = layoutCachePath(path);
+  if (!SD_MMC.exists(cachePath.c_str()))
+    return false;
 
-  if (SAVE_POWER)
-    pocketmage::setCpuSpeed(POWER_SAVE_FREQ);
-  SDActive = false;
+  File file = SD_MMC.open(cachePath.c_str(), FILE_READ);
+  if (!file)
+    return false;
+
+  uint32_t magic, srcSize, srcWrite, editLine, scroll, docCount;
+  uint8_t dirty;
+  uint32_t curSize, curWrite;
+  sourceStamp(path, curSize, curWrite);
+
+  if (!readLayoutValue(file, magic) || magic != LAYOUT_CACHE_MAGIC ||
+      !readLayoutValue(file, dirty) ||
+      !readLayoutValue(file, srcSize) || !readLayoutValue(file, srcWrite) ||
+      !readLayoutValue(file, editLine) || !readLayoutValue(file, scroll) ||
+      !readLayoutValue(file, docCount) || srcSize != curSize || srcWrite != curWrite ||
+      docCount > file.size() / 4) {  // Every line takes at least 4 bytes
+    file.close();
+    return false;
+  }
+
+  std::vector<DocLine> lines;
+  lines.reserve(docCount);
+  std::vector<char> buf;
+  bool ok = true;
+
+  for (uint32_t d = 0; d < docCount && ok; d++) {
+    DocLine dl;
+    uint8_t style;
+    uint16_t lineCount;
+    ok = readLayoutValue(file, style) && readLayoutValue(file, dl.layoutFamily) &&
+         readLayoutValue(file, lineCount);
+    dl.style = style;
+    dl.orderedListNumber = 0;
+
+    for (uint16_t l = 0; l < lineCount && ok; l++) {
+      LineObject ln;
+      ln.index = 0;
+      uint16_t wordCount;
+      ok = readLayoutValue(file, wordCount);
+
+      for (uint16_t w = 0; w < wordCount && ok; w++) {
+        uint8_t flags;
+        uint16_t len;
+        ok = readLayoutValue(file, flags) && readLayoutValue(file, len);
+        if (!ok)
+          break;
+        buf.resize(len + 1);
+        ok = (file.read((uint8_t*)buf.data(), len) == len);
+        buf[len] = '\0';
+        ln.words.push_back({String(buf.data()), (flags & 1) != 0, (flags & 2) != 0});
+      }
+
+      dl.lines.push_back(std::move(ln));
+    }
+
+    lines.push_back(std::move(dl));
+  }
+
+  file.close();
+
+  if (!ok || lines.empty()) {
+    ESP_LOGW(TAG, "Layout cache corrupt: %s", path.c_str());
+    SD_MMC.remove(cachePath.c_str());
+    return false;
+  }
+
+  {
+    DocLock lock;
+    publishDocLines(lines, min((ulong)editLine, (ulong)lines.size() - 1));
+    lineScroll = scroll;
+  }
+
+  openDocPath = path;
+  docDirty = (dirty != 0);
+  openDocSize = curSize;
+  openDocWrite = curWrite;
+  // Lines wrapped for another font family are reflowed in the background
+  requestReflow();
+  fileLoaded = true;
+  return true;
+}
+
+// Write a parked note's unsaved edits to its file, unless the file changed since it was parked
+void saveOpenDocument(OpenDocument& doc) {
+  if (!doc.dirty || SD().getNoSD())
+    return;
+  if (!sourceUnchanged(doc.path, doc.srcSize, doc.srcWrite)) {
+    reportLostEdits(doc.path);
+    doc.dirty = false;
+    return;
+  }
+  if (!writeMarkdownFile(doc.path, compileMarkdown(doc.docLines)))
+    return;
+  doc.dirty = false;
+  sourceStamp(doc.path, doc.srcSize, doc.srcWrite);
+  OLED().toast("Auto-saved " + noteName(doc.path));
+}
+
+void dropOpenDocument(const String& path) {
+  for (size_t i = 0; i < openDocuments.size(); i++) {
+    if (openDocuments[i].path == path) {
+      openDocuments.erase(openDocuments.begin() + i);
+      return;
+    }
+  }
+}
+
+// Evict least recently used notes until the cache fits its budget
+void trimOpenDocuments() {
+  size_t total = 0;
+  for (const auto& doc : openDocuments)
+    total += doc.bytes;
+
+  size_t budget = openDocumentBudget();
+  while (!openDocuments.empty() && total > budget) {
+    OpenDocument& doc = openDocuments.back();
+    ESP_LOGI(TAG, "Evicting %s (%u bytes)", doc.path.c_str(), (unsigned)doc.bytes);
+    saveOpenDocument(doc);
+    writeLayoutCache(doc);
+    total -= doc.bytes;
+    openDocuments.pop_back();
+  }
+}
+
+// Persist unsaved edits of cached notes before sleep or USB
+void flushOpenDocuments() {
+  for (auto& doc : openDocuments) {
+    if (!doc.dirty)
+      continue;
+    saveOpenDocument(doc);
+    writeLayoutCache(doc);
+  }
+}
+
+// Forget every cached note, saving unsaved edits first, before files change under them
+void dropOpenDocuments() {
+  for (auto& doc : openDocuments)
+    saveOpenDocument(doc);
+  openDocuments.clear();
+}
+
+// Files are about to be deleted, renamed or copied over: save and forget cached notes and drop
+// the layout cache of path, which would otherwise outlive the note
+void notesChanging(const String& path) {
+  dropOpenDocuments();
+  if (SD().getNoSD())
+    return;
+  String cachePath = layoutCachePath(path);
+  if (SD_MMC.exists(cachePath.c_str()))
+    SD_MMC.remove(cachePath.c_str());
+}
+
+// Move the open note into the cache, leaving docLines empty
+void parkOpenDocument() {
+  if (openDocPath == "" || openDocPath == "-" || docLines.empty())
+    return;
+
+  dropOpenDocument(openDocPath);
+
+  OpenDocument doc;
+  doc.path = openDocPath;
+  doc.editingLine_index = editingLine_index;
+  doc.dirty = docDirty;
+  doc.srcSize = openDocSize;
+  doc.srcWrite = openDocWrite;
+  {
+    DocLock lock;
+    doc.bytes = estimateDocumentBytes(docLines);
+    doc.docLines = std::move(docLines);
+    doc.outline = std::move(outline);
+    doc.lineScroll = lineScroll;
+    docLines.clear();
+    outline.clear();
+  }
+  openDocuments.insert(openDocuments.begin(), std::move(doc));
+
+  openDocPath = "";
+  docDirty = false;
+
+  trimOpenDocuments();
+}
+
+// Swap a cached note back into docLines, false if it is not cached
+bool restoreOpenDocument(const String& path) {
+  for (size_t i = 0; i < openDocuments.size(); i++) {
+    if (openDocuments[i].path != path)
+      continue;
+
+    OpenDocument& doc = openDocuments[i];
+    if (!sourceUnchanged(path, doc.srcSize, doc.srcWrite)) {
+      if (doc.dirty)
+        reportLostEdits(path);
+      openDocuments.erase(openDocuments.begin() + i);
+      return false;
+    }
+
+    {
+      DocLock lock;
+      docLines = std::move(doc.docLines);
+      outline = std::move(doc.outline);
+      editingLine_index = doc.editingLine_index;
+      lineScroll = doc.lineScroll;
+      refreshAllLineIndexes();
+      invalidatePrerender();
+    }
+    docDirty = doc.dirty;
+    openDocSize = doc.srcSize;
+    openDocWrite = doc.srcWrite;
+    openDocPath = path;
+    openDocuments.erase(openDocuments.begin() + i);
+
+    requestReflow();
+    fileLoaded = true;
+    return true;
+  }
+  return false;
+}
+
+// Make path the open note, from RAM or the layout cache when possible
+void openMarkdownFile(const String& path) {
+  if (path == openDocPath && !docLines.empty()) {
+    if (sourceUnchanged(path, openDocSize, openDocWrite))
+      return;
+
+    // Changed behind our back (USB, FILEWIZ, the old text app), the card wins
+    if (docDirty)
+      reportLostEdits(path);
+    else
+      ESP_LOGW(TAG, "%s changed on disk, reloading", path.c_str());
+    DocLock lock;
+    docLines.clear();
+    outline.clear();
+    openDocPath = "";
+    docDirty = false;
+  }
+
+  parkOpenDocument();
+  if (restoreOpenDocument(path) || loadLayoutCache(path))
+    return;
+
+  loadMarkdownFile(path);
 }
 
 void newMarkdownFile(const String& path) {
+  invalidatePrerender();
+
   if (SD().getNoSD()) {
     OLED().oledWord("SAVE FAILED - No SD!");
     delay(3000);
@@ -1271,12 +2397,15 @@ void newMarkdownFile(const String& path) {
   file.close();
 
   // Save metadata
-  SD().writeMetadata(savePath);
+  SD().writeMetadata(savePath, DocStats());
   SD().setEditingFile(savePath);
 
   OLED().oledWord("Created: " + savePath);
   delay(1000);
 
+  // Keep the current note open, and forget any stale copy of the one just overwritten
+  parkOpenDocument();
+  dropOpenDocument(savePath);
   loadMarkdownFile(savePath);
   updateScreen = true;
 
@@ -1288,17 +2417,18 @@ void newMarkdownFile(const String& path) {
 
 // Returns the pixel width of a LineObject (vector of wordObjects)
 int getLineWidth(const LineObject& lineObj, char style) {
+  Adafruit_GFX& gfx = inputMeasure();
   int lineWidth = 0;
   for (const auto& w : lineObj.words) {
     const GFXfont* font = pickFont(style, w.bold, w.italic);
-    display.setFont(font);
+    gfx.setFont(font);
 
     int16_t x1, y1;
     uint16_t wpx, hpx;
-    display.getTextBounds(w.text.c_str(), 0, 0, &x1, &y1, &wpx, &hpx);
+    gfx.getTextBounds(GlyphText(w.text).c_str(), 0, 0, &x1, &y1, &wpx, &hpx);
 
     uint16_t spaceWidth;
-    display.getTextBounds(SPACEWIDTH_SYMBOL, 0, 0, &x1, &y1, &spaceWidth, &hpx);
+    gfx.getTextBounds(SPACEWIDTH_SYMBOL, 0, 0, &x1, &y1, &spaceWidth, &hpx);
 
     // Add word width + space width (except after last word)
     lineWidth += (wpx + WORDWIDTH_BUFFER);
@@ -1309,16 +2439,34 @@ int getLineWidth(const LineObject& lineObj, char style) {
   return lineWidth;
 }
 
-void editAppend(char inchar) {
-  static ulong lastTypeMillis = 0;
-  ulong currentMillis = millis();
+// Keypress work that sleeps, touches the SD card or leaves the app. applyKeypress() hands it
+// back so editAppend() runs it once docMutex is released.
+enum EditAction { EDIT_NONE, EDIT_DONE, EDIT_HOME, EDIT_JOURNAL, EDIT_NO_HEADINGS, EDIT_SAVE, EDIT_LOAD };
 
+// The line being edited as the OLED shows it, copied out from under docMutex
+struct EditView {
+  LineObject line;
+  wordObject word;
+  char style;
+};
+
+// Applies a keypress to docLines under docMutex. Returns what is left to do and the path for
+// EDIT_SAVE / EDIT_LOAD; EDIT_DONE means the OLED is not redrawn.
+EditAction applyKeypress(char inchar, String& actionPath, EditView& view) {
+  DocLock lock;
+  EditAction action = EDIT_NONE;
   bool moveView = false;
 
   // Lower baseline clock speed here?
 
   // Direct access to DocLine, LineObject, and wordObject
   DocLine& editingDocLine = docLines[editingLine_index];
+
+  // Lines the layout worker has not reached yet are wrapped here before they are edited
+  if (editingDocLine.layoutFamily != fontStyle) {
+    editingDocLine.rewrap();
+    refreshAllLineIndexes();
+  }
   LineObject* lastLine;
   wordObject* lastWord;
 
@@ -1339,6 +2487,7 @@ void editAppend(char inchar) {
   if (inchar != 0) {
     // Increase clock speed here for faster processing?
     pocketmage::setCpuSpeed(240);
+    invalidatePrerender();
   }
 
   // HANDLE INPUTS
@@ -1347,11 +2496,11 @@ void editAppend(char inchar) {
   }
   // Return home
   else if (inchar == 12 && CurrentTXTState_NEW != JOURNAL_MODE) {
-    HOME_INIT();
+    action = EDIT_HOME;
   }
   // Return to journal app if in journal mode
   else if (inchar == 12 && CurrentTXTState_NEW == JOURNAL_MODE) {
-    JOURNAL_INIT();
+    action = EDIT_JOURNAL;
   }
   // TAB Recieved
   else if (inchar == 9) {
@@ -1382,6 +2531,7 @@ void editAppend(char inchar) {
   }
   // Space Recieved
   else if (inchar == 32) {
+    docDirty = true;
     if (getLineWidth(*lastLine, editingDocLine.style) > display.width() - DISPLAY_WIDTH_BUFFER) {
       // Word does not fit -> wrap to new line
       // Remove the word from the old line
@@ -1415,6 +2565,7 @@ void editAppend(char inchar) {
   }
   // ENTER Received
   else if (inchar == 13) {
+    docDirty = true;
     // Check if false blank line
     bool hasAnyText = false;
     for (auto& ln : editingDocLine.lines) {
@@ -1446,6 +2597,7 @@ void editAppend(char inchar) {
     if (currentLineEmpty) {
       editingDocLine.style = 'B';
     }
+    outlineUpdateDocLine(editingLine_index);
 
     // Retain style on next line for certain styles
     char nextLineStyle = editingDocLine.style;
@@ -1471,6 +2623,7 @@ void editAppend(char inchar) {
     // Finish current DocLine and create a new one
     DocLine newDocLine;
     newDocLine.style = nextLineStyle;
+    newDocLine.layoutFamily = fontStyle;
 
     // Add one line and one empty word
     LineObject newLine;
@@ -1481,6 +2634,7 @@ void editAppend(char inchar) {
     // Insert new DocLine immediately after the current one
     editingLine_index++;
     docLines.insert(docLines.begin() + editingLine_index, std::move(newDocLine));
+    outlineInsertDocLine(editingLine_index);
 
     // Update lastLine/lastWord to point to new line
     lastLine = &docLines[editingLine_index].lines.back();
@@ -1493,8 +2647,22 @@ void editAppend(char inchar) {
     updateScreen = true;
     moveView = true;
   }
-  // ESC / CLEAR Recieved
+  // SEL Recieved (Outline picker)
   else if (inchar == 20) {
+    if (outline.empty()) {
+      action = EDIT_NO_HEADINGS;
+    } else {
+      // Start on the section currently being viewed
+      outlineSelection = 0;
+      for (size_t o = 0; o < outline.size(); o++) {
+        if (outline[o].lineIndex <= lineScroll)
+          outlineSelection = o;
+      }
+      pickerReturnState = CurrentTXTState_NEW;
+      CurrentTXTState_NEW = OUTLINE;
+      KB().setKeyboardState(NORMAL);
+      updateScreen = true;
+    }
   }
   // LEFT
   else if (inchar == 19) {
@@ -1504,6 +2672,7 @@ void editAppend(char inchar) {
   }
   // SHFT + LEFT (Text type select)
   else if (inchar == 28) {
+    docDirty = true;
     // Define the cycle order
     static const char styleCycle[] = {'T', '1', '2', '3', '>', 'L', '-', 'C', 'H'};
     static const int numStyles = sizeof(styleCycle) / sizeof(styleCycle[0]);
@@ -1520,9 +2689,11 @@ void editAppend(char inchar) {
     // Move to next style in cycle
     currentIndex = (currentIndex + 1) % numStyles;
     editingDocLine.style = styleCycle[currentIndex];
+    outlineUpdateDocLine(editingLine_index);
   }
   // SHFT + RIGHT (Word type select)
   else if (inchar == 30) {
+    docDirty = true;
     if (lastWord->bold == false && lastWord->italic == false) {
       // If regular text switch to bold
       lastWord->bold = true;
@@ -1543,9 +2714,10 @@ void editAppend(char inchar) {
   }
   // BKSP Received
   else if (inchar == 8) {
+    docDirty = true;
     if (lastWord->text.length() > 0) {
-      // Remove the last character of the current word
-      lastWord->text.remove(lastWord->text.length() - 1);
+      // Remove the last character of the current word, all of its UTF-8 bytes
+      lastWord->text.remove(lastWord->text.length() - utf8LastLength(lastWord->text));
     } else {
       // Current word is empty, move to previous word or line
       LineObject* linePtr = lastLine;
@@ -1572,7 +2744,7 @@ void editAppend(char inchar) {
           wordPtr = &linePtr->words.back();
         } else {
           // At very start of document, nothing to do
-          return;
+          return EDIT_DONE;
         }
       }
 
@@ -1587,17 +2759,19 @@ void editAppend(char inchar) {
     if (savePath == "" || savePath == "-" || savePath == "/temp.txt") {
       KB().setKeyboardState(NORMAL);
       CurrentTXTState_NEW = SAVE_AS;
-      return;
+      return EDIT_DONE;
     }
     if (!savePath.startsWith("/")) savePath = "/" + savePath;
     
-    saveMarkdownFile(savePath);
+    action = EDIT_SAVE;
+    actionPath = savePath;
   }
   // Journal save
   else if (inchar == 6 && CurrentTXTState_NEW == JOURNAL_MODE) {
     String savePath = getCurrentJournal();
     if (!savePath.startsWith("/")) savePath = "/" + savePath;
-    saveMarkdownFile(savePath);
+    action = EDIT_SAVE;
+    actionPath = savePath;
   }
 
   // FILE recieved
@@ -1615,17 +2789,20 @@ void editAppend(char inchar) {
   else if (inchar == 7 && CurrentTXTState_NEW == JOURNAL_MODE) {
     String outPath = getCurrentJournal();
     if (!outPath.startsWith("/")) outPath = "/" + outPath;
-    loadMarkdownFile(outPath);
+    action = EDIT_LOAD;
+    actionPath = outPath;
   }
 
   // Font Switcher
   else if (inchar == 14) {
+    pickerReturnState = CurrentTXTState_NEW;
     CurrentTXTState_NEW = FONT;
     KB().setKeyboardState(FUNC);
     updateScreen = true;
   } else {
     // Add char to current word
     lastWord->text += inchar;
+    docDirty = true;
 
     if (inchar >= 48 && inchar <= 57) {
     }  // Only leave FN on if typing numbers
@@ -1634,6 +2811,58 @@ void editAppend(char inchar) {
     }
   }
 
+  // Center scroll on typed line if a line update has been registered. Enter and backspace may
+  // have moved to another DocLine, so look it up again.
+  DocLine& currentDocLine = docLines[editingLine_index];
+  if (moveView) {
+    // Update scroll to currently edited line
+    if (currentDocLine.lines.empty())
+      lineScroll = 0;
+    else
+      lineScroll = currentDocLine.lines.back().index;
+  }
+
+  // Typing into a line, or moving onto one, inside a collapsed section shows it again
+  if (inchar != 0 && action == EDIT_NONE &&
+      (CurrentTXTState_NEW == TXT_ || CurrentTXTState_NEW == JOURNAL_MODE) &&
+      revealDocLine(editingLine_index))
+    updateScreen = true;
+
+  view.line = *lastLine;
+  view.word = *lastWord;
+  view.style = currentDocLine.style;
+  return action;
+}
+
+void editAppend(char inchar) {
+  static ulong lastTypeMillis = 0;
+  ulong currentMillis = millis();
+
+  String actionPath;
+  EditView view;
+  switch (applyKeypress(inchar, actionPath, view)) {
+    case EDIT_DONE:
+      return;
+    case EDIT_HOME:
+      HOME_INIT();
+      break;
+    case EDIT_JOURNAL:
+      JOURNAL_INIT();
+      break;
+    case EDIT_NO_HEADINGS:
+      OLED().oledWord("No Headings");
+      delay(500);
+      break;
+    case EDIT_SAVE:
+      saveMarkdownFile(actionPath);
+      break;
+    case EDIT_LOAD:
+      loadMarkdownFile(actionPath);
+      break;
+    case EDIT_NONE:
+      break;
+  }
+
   if (inchar != 0) {
     // Typing is happening
     lastTypeMillis = millis();
@@ -1651,146 +2880,144 @@ void editAppend(char inchar) {
       if (!currentlyTyping)
         keypad.flush();
 
-      int lineWidth = getLineWidth(*lastLine, editingDocLine.style);
+      int lineWidth = getLineWidth(view.line, view.style);
 
-      oledEditorDisplay(*lastLine, *lastWord, lineWidth, currentlyTyping);
+      oledEditorDisplay(view.line, view.word, lineWidth, currentlyTyping);
     } else {
       // Scrolling display function here
       scrollPreview();
     }
   }
 
-  // Center scroll on typed line if a line update has been registered
-  if (moveView) {
-    // Update scroll to currently edited line
-    if (editingDocLine.lines.empty())
-      lineScroll = 0;
-    else
-      lineScroll = editingDocLine.lines.back().index;
-  }
-
   if (SAVE_POWER) setCpuFrequencyMhz(POWER_SAVE_FREQ);
 }
 
 // INIT
+// Faces come from FONTS_DIR on the card; the stand-ins are the 7-bit fonts the library carries
+FontRef packFont(const char* name, const GFXfont* builtin) {
+  return {FONTS().find(name), builtin};
+}
+
 void initFonts() {
   // Mono
-  fonts[mono].normal = &FreeMono9pt8b;
-  fonts[mono].normal_B = &FreeMonoBold9pt8b;
-  fonts[mono].normal_I = &FreeMonoOblique9pt8b;
-  fonts[mono].normal_BI = &FreeMonoBoldOblique9pt8b;
-
-  fonts[mono].h1 = &FreeMonoBold24pt8b;
-  fonts[mono].h1_B = &FreeMonoBold24pt8b;  // Already bold
-  fonts[mono].h1_I = &FreeMonoBoldOblique24pt8b;
-  fonts[mono].h1_BI = &FreeMonoBoldOblique24pt8b;
-
-  fonts[mono].h2 = &FreeMonoBold18pt8b;
-  fonts[mono].h2_B = &FreeMonoBold18pt8b;
-  fonts[mono].h2_I = &FreeMonoBoldOblique18pt8b;
-  fonts[mono].h2_BI = &FreeMonoBoldOblique18pt8b;
-
-  fonts[mono].h3 = &FreeMonoBold12pt8b;
-  fonts[mono].h3_B = &FreeMonoBold12pt8b;
-  fonts[mono].h3_I = &FreeMonoBoldOblique12pt8b;
-  fonts[mono].h3_BI = &FreeMonoBoldOblique12pt8b;
-
-  fonts[mono].code = &FreeMono9pt8b;
-  fonts[mono].code_B = &FreeMono9pt8b;
-  fonts[mono].code_I = &FreeMono9pt8b;
-  fonts[mono].code_BI = &FreeMono9pt8b;
-
-  fonts[mono].quote = &FreeMono9pt8b;
-  fonts[mono].quote_B = &FreeMonoBold9pt8b;
-  fonts[mono].quote_I = &FreeMonoOblique9pt8b;
-  fonts[mono].quote_BI = &FreeMonoBoldOblique9pt8b;
-
-  fonts[mono].list = &FreeMono9pt8b;
-  fonts[mono].list_B = &FreeMonoBold9pt8b;
-  fonts[mono].list_I = &FreeMonoOblique9pt8b;
-  fonts[mono].list_BI = &FreeMonoBoldOblique9pt8b;
+  fonts[mono].normal = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].normal_B = packFont("FreeMonoBold9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].normal_I = packFont("FreeMonoOblique9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].normal_BI = packFont("FreeMonoBoldOblique9pt8b", &FreeMonoBold9pt7b);
+
+  fonts[mono].h1 = packFont("FreeMonoBold24pt8b", &FreeMono12pt7b);
+  fonts[mono].h1_B = packFont("FreeMonoBold24pt8b", &FreeMono12pt7b);  // Already bold
+  fonts[mono].h1_I = packFont("FreeMonoBoldOblique24pt8b", &FreeMono12pt7b);
+  fonts[mono].h1_BI = packFont("FreeMonoBoldOblique24pt8b", &FreeMono12pt7b);
+
+  fonts[mono].h2 = packFont("FreeMonoBold18pt8b", &FreeMono12pt7b);
+  fonts[mono].h2_B = packFont("FreeMonoBold18pt8b", &FreeMono12pt7b);
+  fonts[mono].h2_I = packFont("FreeMonoBoldOblique18pt8b", &FreeMono12pt7b);
+  fonts[mono].h2_BI = packFont("FreeMonoBoldOblique18pt8b", &FreeMono12pt7b);
+
+  fonts[mono].h3 = packFont("FreeMonoBold12pt8b", &FreeMono12pt7b);
+  fonts[mono].h3_B = packFont("FreeMonoBold12pt8b", &FreeMono12pt7b);
+  fonts[mono].h3_I = packFont("FreeMonoBoldOblique12pt8b", &FreeMono12pt7b);
+  fonts[mono].h3_BI = packFont("FreeMonoBoldOblique12pt8b", &FreeMono12pt7b);
+
+  fonts[mono].code = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].code_B = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].code_I = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].code_BI = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+
+  fonts[mono].quote = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].quote_B = packFont("FreeMonoBold9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].quote_I = packFont("FreeMonoOblique9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].quote_BI = packFont("FreeMonoBoldOblique9pt8b", &FreeMonoBold9pt7b);
+
+  fonts[mono].list = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].list_B = packFont("FreeMonoBold9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].list_I = packFont("FreeMonoOblique9pt8b", &FreeMonoBold9pt7b);
+  fonts[mono].list_BI = packFont("FreeMonoBoldOblique9pt8b", &FreeMonoBold9pt7b);
 
   // Serif
-  fonts[serif].normal = &FreeSerif9pt8b;
-  fonts[serif].normal_B = &FreeSerifBold9pt8b;
-  fonts[serif].normal_I = &FreeSerifItalic9pt8b;
-  fonts[serif].normal_BI = &FreeSerifBoldItalic9pt8b;
-
-  fonts[serif].h1 = &FreeSerifBold24pt8b;
-  fonts[serif].h1_B = &FreeSerifBold24pt8b;
-  fonts[serif].h1_I = &FreeSerifBoldItalic24pt8b;
-  fonts[serif].h1_BI = &FreeSerifBoldItalic24pt8b;
-
-  fonts[serif].h2 = &FreeSerifBold18pt8b;
-  fonts[serif].h2_B = &FreeSerifBold18pt8b;
-  fonts[serif].h2_I = &FreeSerifBoldItalic18pt8b;
-  fonts[serif].h2_BI = &FreeSerifBoldItalic18pt8b;
-
-  fonts[serif].h3 = &FreeSerifBold12pt8b;
-  fonts[serif].h3_B = &FreeSerifBold12pt8b;
-  fonts[serif].h3_I = &FreeSerifBoldItalic12pt8b;
-  fonts[serif].h3_BI = &FreeSerifBoldItalic12pt8b;
-
-  fonts[serif].code = &FreeMono9pt8b;
-  fonts[serif].code_B = &FreeMono9pt8b;
-  fonts[serif].code_I = &FreeMono9pt8b;
-  fonts[serif].code_BI = &FreeMono9pt8b;
-
-  fonts[serif].quote = &FreeSerif9pt8b;
-  fonts[serif].quote_B = &FreeSerifBold9pt8b;
-  fonts[serif].quote_I = &FreeSerifItalic9pt8b;
-  fonts[serif].quote_BI = &FreeSerifBoldItalic9pt8b;
-
-  fonts[serif].list = &FreeSerif9pt8b;
-  fonts[serif].list_B = &FreeSerifBold9pt8b;
-  fonts[serif].list_I = &FreeSerifItalic9pt8b;
-  fonts[serif].list_BI = &FreeSerifBoldItalic9pt8b;
+  fonts[serif].normal = packFont("FreeSerif9pt8b", &FreeSerif9pt7b);
+  fonts[serif].normal_B = packFont("FreeSerifBold9pt8b", &FreeSerifBold9pt7b);
+  fonts[serif].normal_I = packFont("FreeSerifItalic9pt8b", &FreeSerif9pt7b);
+  fonts[serif].normal_BI = packFont("FreeSerifBoldItalic9pt8b", &FreeSerifBold9pt7b);
+
+  fonts[serif].h1 = packFont("FreeSerifBold24pt8b", &FreeSerif12pt7b);
+  fonts[serif].h1_B = packFont("FreeSerifBold24pt8b", &FreeSerif12pt7b);
+  fonts[serif].h1_I = packFont("FreeSerifBoldItalic24pt8b", &FreeSerif12pt7b);
+  fonts[serif].h1_BI = packFont("FreeSerifBoldItalic24pt8b", &FreeSerif12pt7b);
+
+  fonts[serif].h2 = packFont("FreeSerifBold18pt8b", &FreeSerif12pt7b);
+  fonts[serif].h2_B = packFont("FreeSerifBold18pt8b", &FreeSerif12pt7b);
+  fonts[serif].h2_I = packFont("FreeSerifBoldItalic18pt8b", &FreeSerif12pt7b);
+  fonts[serif].h2_BI = packFont("FreeSerifBoldItalic18pt8b", &FreeSerif12pt7b);
+
+  fonts[serif].h3 = packFont("FreeSerifBold12pt8b", &FreeSerif12pt7b);
+  fonts[serif].h3_B = packFont("FreeSerifBold12pt8b", &FreeSerif12pt7b);
+  fonts[serif].h3_I = packFont("FreeSerifBoldItalic12pt8b", &FreeSerif12pt7b);
+  fonts[serif].h3_BI = packFont("FreeSerifBoldItalic12pt8b", &FreeSerif12pt7b);
+
+  fonts[serif].code = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[serif].code_B = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[serif].code_I = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[serif].code_BI = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+
+  fonts[serif].quote = packFont("FreeSerif9pt8b", &FreeSerif9pt7b);
+  fonts[serif].quote_B = packFont("FreeSerifBold9pt8b", &FreeSerifBold9pt7b);
+  fonts[serif].quote_I = packFont("FreeSerifItalic9pt8b", &FreeSerif9pt7b);
+  fonts[serif].quote_BI = packFont("FreeSerifBoldItalic9pt8b", &FreeSerifBold9pt7b);
+
+  fonts[serif].list = packFont("FreeSerif9pt8b", &FreeSerif9pt7b);
+  fonts[serif].list_B = packFont("FreeSerifBold9pt8b", &FreeSerifBold9pt7b);
+  fonts[serif].list_I = packFont("FreeSerifItalic9pt8b", &FreeSerif9pt7b);
+  fonts[serif].list_BI = packFont("FreeSerifBoldItalic9pt8b", &FreeSerifBold9pt7b);
 
   // Sans
-  fonts[sans].normal = &FreeSans9pt8b;
-  fonts[sans].normal_B = &FreeSansBold9pt8b;
-  fonts[sans].normal_I = &FreeSansOblique9pt8b;
-  fonts[sans].normal_BI = &FreeSansBoldOblique9pt8b;
-
-  fonts[sans].h1 = &FreeSansBold24pt8b;
-  fonts[sans].h1_B = &FreeSansBold24pt8b;
-  fonts[sans].h1_I = &FreeSansBoldOblique24pt8b;
-  fonts[sans].h1_BI = &FreeSansBoldOblique24pt8b;
-
-  fonts[sans].h2 = &FreeSansBold18pt8b;
-  fonts[sans].h2_B = &FreeSansBold18pt8b;
-  fonts[sans].h2_I = &FreeSansBoldOblique18pt8b;
-  fonts[sans].h2_BI = &FreeSansBoldOblique18pt8b;
-
-  fonts[sans].h3 = &FreeSansBold12pt8b;
-  fonts[sans].h3_B = &FreeSansBold12pt8b;
-  fonts[sans].h3_I = &FreeSansBoldOblique12pt8b;
-  fonts[sans].h3_BI = &FreeSansBoldOblique12pt8b;
-
-  fonts[sans].code = &FreeMono9pt8b;
-  fonts[sans].code_B = &FreeMono9pt8b;
-  fonts[sans].code_I = &FreeMono9pt8b;
-  fonts[sans].code_BI = &FreeMono9pt8b;
-
-  fonts[sans].quote = &FreeSans9pt8b;
-  fonts[sans].quote_B = &FreeSansBold9pt8b;
-  fonts[sans].quote_I = &FreeSansOblique9pt8b;
-  fonts[sans].quote_BI = &FreeSansBoldOblique9pt8b;
-
-  fonts[sans].list = &FreeSans9pt8b;
-  fonts[sans].list_B = &FreeSansBold9pt8b;
-  fonts[sans].list_I = &FreeSansOblique9pt8b;
-  fonts[sans].list_BI = &FreeSansBoldOblique9pt8b;
+  fonts[sans].normal = packFont("FreeSans9pt8b", &FreeSans9pt7b);
+  fonts[sans].normal_B = packFont("FreeSansBold9pt8b", &FreeSans9pt7b);
+  fonts[sans].normal_I = packFont("FreeSansOblique9pt8b", &FreeSans9pt7b);
+  fonts[sans].normal_BI = packFont("FreeSansBoldOblique9pt8b", &FreeSans9pt7b);
+
+  fonts[sans].h1 = packFont("FreeSansBold24pt8b", &FreeSans12pt7b);
+  fonts[sans].h1_B = packFont("FreeSansBold24pt8b", &FreeSans12pt7b);
+  fonts[sans].h1_I = packFont("FreeSansBoldOblique24pt8b", &FreeSans12pt7b);
+  fonts[sans].h1_BI = packFont("FreeSansBoldOblique24pt8b", &FreeSans12pt7b);
+
+  fonts[sans].h2 = packFont("FreeSansBold18pt8b", &FreeSans12pt7b);
+  fonts[sans].h2_B = packFont("FreeSansBold18pt8b", &FreeSans12pt7b);
+  fonts[sans].h2_I = packFont("FreeSansBoldOblique18pt8b", &FreeSans12pt7b);
+  fonts[sans].h2_BI = packFont("FreeSansBoldOblique18pt8b", &FreeSans12pt7b);
+
+  fonts[sans].h3 = packFont("FreeSansBold12pt8b", &FreeSans12pt7b);
+  fonts[sans].h3_B = packFont("FreeSansBold12pt8b", &FreeSans12pt7b);
+  fonts[sans].h3_I = packFont("FreeSansBoldOblique12pt8b", &FreeSans12pt7b);
+  fonts[sans].h3_BI = packFont("FreeSansBoldOblique12pt8b", &FreeSans12pt7b);
+
+  fonts[sans].code = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[sans].code_B = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[sans].code_I = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+  fonts[sans].code_BI = packFont("FreeMono9pt8b", &FreeMonoBold9pt7b);
+
+  fonts[sans].quote = packFont("FreeSans9pt8b", &FreeSans9pt7b);
+  fonts[sans].quote_B = packFont("FreeSansBold9pt8b", &FreeSans9pt7b);
+  fonts[sans].quote_I = packFont("FreeSansOblique9pt8b", &FreeSans9pt7b);
+  fonts[sans].quote_BI = packFont("FreeSansBoldOblique9pt8b", &FreeSans9pt7b);
+
+  fonts[sans].list = packFont("FreeSans9pt8b", &FreeSans9pt7b);
+  fonts[sans].list_B = packFont("FreeSansBold9pt8b", &FreeSans9pt7b);
+  fonts[sans].list_I = packFont("FreeSansOblique9pt8b", &FreeSans9pt7b);
+  fonts[sans].list_BI = packFont("FreeSansBoldOblique9pt8b", &FreeSans9pt7b);
 }
 
 void TXT_INIT() {
   initFonts();
+  initLayoutWorker();
 
-  loadMarkdownFile(SD().getEditingFile());
-
-  setFontStyle(serif);
+  {
+    DocLock lock;
+    setFontStyle(serif);
+  }
 
-  lineScroll = 0;
+  openMarkdownFile(SD().getEditingFile());
   updateScreen = true;
   CurrentAppState = TXT;
   CurrentTXTState_NEW = TXT_;
@@ -1798,14 +3025,16 @@ void TXT_INIT() {
 
 void TXT_INIT_JournalMode() {
   initFonts();
+  initLayoutWorker();
 
   String outPath = getCurrentJournal();
   if (!outPath.startsWith("/")) outPath = "/" + outPath;
-  loadMarkdownFile(outPath);
-
-  setFontStyle(serif);
+  {
+    DocLock lock;
+    setFontStyle(serif);
+  }
 
-  lineScroll = 0;
+  openMarkdownFile(outPath);
   updateScreen = true;
   CurrentAppState = TXT;
   CurrentTXTState_NEW = JOURNAL_MODE;
@@ -1814,14 +3043,88 @@ void TXT_INIT_JournalMode() {
 void einkHandler_TXT_NEW() {
   if (updateScreen) {
     updateScreen = false;
+    FONTS().trim();
     display.setFullWindow();
     display.fillScreen(GxEPD_WHITE);
-    displayDocument();
-    EINK().refresh();
-    refreshAllLineIndexes();
+    if (CurrentTXTState_NEW == OUTLINE) {
+      {
+        DocLock lock;
+        drawOutlinePicker();
+      }
+      EINK().refresh();
+      return;
+    }
+    if (CurrentTXTState_NEW == FONT) {
+      drawFontPicker();
+      EINK().refresh();
+      return;
+    }
+
+    // Scrolling onto a pre-rendered page skips layout and glyph rendering. The page goes out on
+    // the refresh task, so line indexes and pre-rendering carry on while the panel updates.
+    // renderDocument() copies the lines it needs, docMutex is never held while drawing.
+    EinkCanvas* page = EINK().beginFrame();
+    ulong scroll;
+    {
+      DocLock lock;
+      scroll = lineScroll;
+    }
+    if (!page) {
+      renderDocument(display, scroll);
+    } else if (!commitPrerenderedPage(scroll, *page)) {
+      page->fillScreen(GxEPD_WHITE);
+      renderDocument(*page, scroll);
+    }
+    if (page)
+      EINK().present();
+    else
+      EINK().refresh();
+    {
+      DocLock lock;
+      refreshAllLineIndexes();
+    }
+
+    // Pre-render the next pages one swipe of the same length away
+    if (scroll != prerenderBase) {
+      ulong from, to;
+      {
+        DocLock lock;
+        from = visibleLineRank(prerenderBase);
+        to = visibleLineRank(scroll);
+      }
+      ulong swipe = (to > from) ? to - from : from - to;
+      prerenderStep = min(swipe, (ulong)PRERENDER_STEP);
+    }
+    prerenderBase = scroll;
+    EINK().requestRedraw(REDRAW_IDLE);
+  } else {
+    prerenderAdjacentPages();
   }
 }
 
+// Slider scroll over the document. docMutex is held to read the range and to move lineScroll,
+// not while the touch controller is read.
+bool updateDocumentScroll() {
+  int total;
+  ulong rank;
+  {
+    DocLock lock;
+    total = getTotalDisplayLines();
+    rank = visibleLineRank(lineScroll);
+  }
+  // lineScroll follows the finger over shown lines; true once the touch ends on a new line
+  ulong scroll = rank;
+  const bool released = TOUCH().updateScroll(total, scroll);
+
+  if (scroll != rank) {
+    DocLock lock;
+    lineScroll = visibleLineIndex(scroll);
+  }
+  return released;
+}
+
+// Input runs on core 1 without docMutex; only the edits themselves take it, so typing never
+// waits for a page to be laid out or drawn on core 0
 void processKB_TXT_NEW() {
   OLED().setPowerSave(false);
   disableTimeout = false;
@@ -1835,7 +3138,7 @@ void processKB_TXT_NEW() {
       inchar = KB().updateKeypress();
       if (currentMillis - KBBounceMillis >= KB_COOLDOWN) {
         // update scroll
-        if (TOUCH().updateScroll(getTotalDisplayLines(), lineScroll)) {
+        if (updateDocumentScroll()) {
           updateScreen = true;
         }
         switch (currentEditMode) {
@@ -1852,7 +3155,7 @@ void processKB_TXT_NEW() {
       inchar = KB().updateKeypress();
       if (currentMillis - KBBounceMillis >= KB_COOLDOWN) {
         // update scroll
-        if (TOUCH().updateScroll(getTotalDisplayLines(), lineScroll)) {
+        if (updateDocumentScroll()) {
           updateScreen = true;
         }
         switch (currentEditMode) {
@@ -2003,6 +3306,82 @@ void processKB_TXT_NEW() {
         }
       }
       break;
+    case FONT:
+      inchar = KB().updateKeypress();
+      if (currentMillis - KBBounceMillis >= KB_COOLDOWN) {
+        // HANDLE INPUTS
+        //No char recieved
+        if (inchar == 0);
+        // 1-3 pick a family, the layout worker redraws once the view is reflowed
+        else if (inchar >= '1' && inchar <= '3') {
+          if (!changeFontFamily(inchar - '1'))
+            updateScreen = true;
+          CurrentTXTState_NEW = pickerReturnState;
+          KB().setKeyboardState(NORMAL);
+        }
+        // Home / BKSP returns without changing
+        else if (inchar == 12 || inchar == 8) {
+          CurrentTXTState_NEW = pickerReturnState;
+          KB().setKeyboardState(NORMAL);
+          updateScreen = true;
+        }
+
+        currentMillis = millis();
+        //Make sure oled only updates at OLED_MAX_FPS
+        if (CurrentTXTState_NEW == FONT && currentMillis - OLEDFPSMillis >= (1000/OLED_MAX_FPS)) {
+          OLEDFPSMillis = currentMillis;
+          fontPickerOLED();
+        }
+      }
+      break;
+    case OUTLINE:
+      inchar = KB().updateKeypress();
+      if (currentMillis - KBBounceMillis >= KB_COOLDOWN) {
+        // HANDLE INPUTS
+        //No char recieved
+        if (inchar == 0);
+        // LEFT / RIGHT move the selection
+        else if (inchar == 19 || inchar == 28) {
+          if (outlineSelection > 0) outlineSelection--;
+          updateScreen = true;
+        }
+        else if (inchar == 21 || inchar == 30) {
+          DocLock lock;
+          if (outlineSelection < (int)outline.size() - 1) outlineSelection++;
+          updateScreen = true;
+        }
+        // TAB toggles the section
+        else if (inchar == 9) {
+          DocLock lock;
+          if (outlineSelection < (int)outline.size()) {
+            outline[outlineSelection].collapsed = !outline[outlineSelection].collapsed;
+            invalidatePrerender();
+            updateScreen = true;
+          }
+        }
+        // SEL / CR jumps to the section
+        else if (inchar == 20 || inchar == 13) {
+          {
+            DocLock lock;
+            jumpToOutlineEntry(outlineSelection);
+          }
+          CurrentTXTState_NEW = pickerReturnState;
+          updateScreen = true;
+        }
+        // Home / BKSP returns without moving
+        else if (inchar == 12 || inchar == 8) {
+          CurrentTXTState_NEW = pickerReturnState;
+          updateScreen = true;
+        }
+
+        currentMillis = millis();
+        //Make sure oled only updates at OLED_MAX_FPS
+        if (CurrentTXTState_NEW == OUTLINE && currentMillis - OLEDFPSMillis >= (1000/OLED_MAX_FPS)) {
+          OLEDFPSMillis = currentMillis;
+          outlinePickerOLED();
+        }
+      }
+      break;
     case LOAD_FILE:
       outPath = fileWizardMini(false, "/notes");
       if (outPath == "_EXIT_") {
@@ -2015,7 +3394,7 @@ void processKB_TXT_NEW() {
         // Ensure file is a .txt or .md
         if (outPath.endsWith(".txt") || outPath.endsWith(".md")) {
           if (!outPath.startsWith("/")) outPath = "/" + outPath;
-          loadMarkdownFile(outPath);
+          openMarkdownFile(outPath);
           SD().setEditingFile(outPath);
           CurrentTXTState_NEW = TXT_;
           updateScreen = true;
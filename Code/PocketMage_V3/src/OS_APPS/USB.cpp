@@ -53,7 +53,7 @@ void USBAppShutdown() {
     } else {
       OLED().oledWord("Insert SD Card and Reboot!");
       delay(5000);
-      u8g2.setPowerSave(1);
+      OLED().setPowerSave(true);
       BZ().playJingle(Jingles::Shutdown);
       esp_deep_sleep_start();
       return;
@@ -62,6 +62,10 @@ void USBAppShutdown() {
 
   if (!SD_MMC.exists("/sys"))     SD_MMC.mkdir("/sys");
   if (!SD_MMC.exists("/journal")) SD_MMC.mkdir("/journal");
+  // The host may have changed the backgrounds or fonts folders, or any note
+  invalidateBackgroundIndex();
+  FONTS().clear();
+  dropOpenDocuments();
   if (SAVE_POWER) pocketmage::setCpuSpeed(POWER_SAVE_FREQ);
   disableTimeout = false;
 
@@ -128,6 +132,9 @@ void USB_INIT() {
 
   if (mscEnabled) return;
 
+  // Notes parked by the text app go to the card before the host gets it
+  flushOpenDocuments();
+
   ESP_LOGI(TAG, "Unmounting SD_MMC for USB MSC...");
 
   SD_MMC.end();  // unmount FS before raw access
@@ -227,7 +234,7 @@ void einkHandler_USB() {
     EINK().drawStatusBar("Connect to a Computer:");
 
     // Display Background
-    display.drawBitmap(0, 0, _usb, 320, 218, GxEPD_BLACK);
+    ASSETS().draw(ASSET_USB, 0, 0, display);
 
     EINK().multiPassRefresh(2);
   }
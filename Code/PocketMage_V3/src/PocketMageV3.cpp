@@ -88,7 +88,7 @@ void processKB() {
       // pocketmage::deepSleep();
     }
 
-    u8g2.sendBuffer();
+    OLED().sendBuffer();
     delay(10);
     #if OTA_APP
     processKB_APP(); // OTA_APP: entry point
@@ -148,6 +148,9 @@ void processKB() {
 // SETUP
 void setup() {
   PocketMage_INIT();
+  #if !OTA_APP // POCKETMAGE_OS
+    SD().setFilesChangingCallback(notesChanging);
+  #endif
 }
 
 // Keyboard / OLED Loop
@@ -172,9 +175,12 @@ void loop() {
 void einkHandler(void* parameter) {
   vTaskDelay(pdMS_TO_TICKS(250)); 
   for (;;) {
-    applicationEinkHandler();
+    // Draws recorded on the input loop go to the display before the app's own pass
+    EINK().replayDisplayLists();
+    if (!EINK().appPassesHeld()) applicationEinkHandler();
 
-    vTaskDelay(pdMS_TO_TICKS(50));
+    // Sleep until an app or input handler calls EINK().requestRedraw()
+    EINK().waitForRedraw();
     yield();
   }
 }
\ No newline at end of file
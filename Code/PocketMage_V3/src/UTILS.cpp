@@ -18,9 +18,34 @@ void printDebug() {
     // Display system time
     ESP_LOGD(TAG, "SYSTEM_CLOCK: %d/%d/%d (%s) %d:%d:%d", now.month(), now.day(), now.year(),
         daysOfTheWeek[now.dayOfTheWeek()], now.hour(), now.minute(), now.second());
+
+    // Shared SPI bus use over the last second
+    SPIBUS().logStats();
     }
 }
 
+// Text sleep screen: the open note with the sleep badge. The e-ink task draws and refreshes it
+// as one display list and runs no app pass after it, so nothing can clear or redraw the buffer
+// before deepSleep(true).
+static void showTextSleepScreen() {
+    EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
+    EinkDisplayList sleepScreen;
+    sleepScreen.draw([](Adafruit_GFX&) { EINK().einkTextDynamic(true, true); });
+    sleepScreen.fillRect(0, display.height() - 26, display.width(), 26, GxEPD_WHITE);
+    sleepScreen.drawRect(0, display.height() - 20, display.width(), 20, GxEPD_BLACK);
+    //display.drawBitmap(display.width() - 30, display.height() - 20, KBStatusallArray[6], 30,
+    //                20, GxEPD_BLACK);
+    sleepScreen.draw([](Adafruit_GFX&) { EINK().statusBar(SD().getEditingFile(), true); });
+
+    sleepScreen.fillRect(320 - 86, 240 - 52, 87, 52, GxEPD_WHITE);
+    sleepScreen.drawBitmap(320 - 86, 240 - 52, sleep1, 87, 52, GxEPD_BLACK);
+    sleepScreen.commit(COMMIT_SLOW_FULL);
+
+    EINK().holdAppPasses();
+    EINK().submit(std::move(sleepScreen));
+    EINK().waitForDisplayLists();
+}
+
 void checkTimeout() {
     int randomScreenSaver = 0;
     CLOCK().setTimeoutMillis(millis());
@@ -61,25 +86,8 @@ void checkTimeout() {
                 #if !OTA_APP
                 case TXT:
                 if (SLEEPMODE == "TEXT" && SD().getEditingFile() != "" && !OTA_APP) {
-                    /*
-                    EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
-                    display.setFullWindow();
-                    EINK().einkTextDynamic(true, true);
-
-                    display.setFont(&FreeMonoBold9pt7b);
-
-                    display.fillRect(0, display.height() - 26, display.width(), 26, GxEPD_WHITE);
-                    display.drawRect(0, display.height() - 20, display.width(), 20, GxEPD_BLACK);
-                    display.setCursor(4, display.height() - 6);
-                    //display.drawBitmap(display.width() - 30, display.height() - 20, KBStatusallArray[6], 30,
-                    //                20, GxEPD_BLACK);
-                    EINK().statusBar(editingFile, true);
-
-                    display.fillRect(320 - 86, 240 - 52, 87, 52, GxEPD_WHITE);
-                    display.drawBitmap(320 - 86, 240 - 52, sleep1, 87, 52, GxEPD_BLACK);
-
                     // Put device to sleep with alternate sleep screen
-                    */
+                    showTextSleepScreen();
                     pocketmage::deepSleep(true);
                 } else
                     pocketmage::deepSleep();
@@ -127,8 +135,9 @@ void checkTimeout() {
         BZ().playJingle(Jingles::Shutdown);
         
         // Clear screen
-        display.setFullWindow();
-        display.fillScreen(GxEPD_WHITE);
+        EinkDisplayList clear;
+        clear.fillScreen(GxEPD_WHITE);
+        EINK().submit(std::move(clear));
 
         } else {
             ESP_LOGD(TAG,"Not charging");
@@ -137,21 +146,7 @@ void checkTimeout() {
                 case TXT:
                 if (SLEEPMODE == "TEXT" && SD().getEditingFile() != "" && !OTA_APP) {
                     ESP_LOGE(TAG,"text sleep mode");   
-                    EINK().setFullRefreshAfter(FULL_REFRESH_AFTER + 1);
-                    display.setFullWindow();
-                    EINK().einkTextDynamic(true, true);
-                    display.setFont(&FreeMonoBold9pt7b);
-
-                    display.fillRect(0, display.height() - 26, display.width(), 26, GxEPD_WHITE);
-                    display.drawRect(0, display.height() - 20, display.width(), 20, GxEPD_BLACK);
-                    display.setCursor(4, display.height() - 6);
-                    //display.drawBitmap(display.width() - 30, display.height() - 20, KBStatusallArray[6], 30,
-                    //                20, GxEPD_BLACK);
-                    EINK().statusBar(SD().getEditingFile(), true);
-
-                    display.fillRect(320 - 86, 240 - 52, 87, 52, GxEPD_WHITE);
-                    display.drawBitmap(320 - 86, 240 - 52, sleep1, 87, 52, GxEPD_BLACK);
-
+                    showTextSleepScreen();
                     pocketmage::deepSleep(true);
                 }
                 // Sleep device normally
@@ -178,13 +173,13 @@ void checkTimeout() {
         CurrentHOMEState = HOME_HOME;
         PWR_BTN_event = false;
         OLED().setPowerSave(false);
-        display.fillScreen(GxEPD_WHITE);
-        EINK().forceSlowFullUpdate(true);
-
         // Play startup jingle
         BZ().playJingle(Jingles::Startup);
 
-        EINK().refresh();
+        EinkDisplayList clear;
+        clear.fillScreen(GxEPD_WHITE);
+        clear.commit(COMMIT_SLOW_FULL);
+        EINK().submit(std::move(clear));
         delay(200);
         newState = true;
     }
@@ -215,7 +210,7 @@ void loadState(bool changeState) {
         return;
     }
 
-    u8g2.setContrast(OLED_BRIGHTNESS);
+    OLED().setContrast(OLED_BRIGHTNESS);
 
     // OTA_APP: remove if statement
     // Update State (if needed)
@@ -377,6 +372,7 @@ void saveEditingFile() {
             saveMarkdownFile(SD().getEditingFile());
             ESP_LOGE(TAG, "Done saving MarkdownFile");
         }
+        flushOpenDocuments();
     } 
 }
 #endif
\ No newline at end of file
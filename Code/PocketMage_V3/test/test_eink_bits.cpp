@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "../lib/PocketMage/include/eink_bits.h"
+
+// Same geometry as EinkCanvas and the ghost tiles
+static const uint16_t STRIDE   = 240 / 8;
+static const uint16_t HEIGHT   = 320;
+static const size_t   BYTES    = (size_t)STRIDE * HEIGHT;
+static const uint16_t TILE     = 40;
+static const uint8_t  TILE_COLS = (240 + TILE - 1) / TILE;
+static const uint8_t  TILE_ROWS = (HEIGHT + TILE - 1) / TILE;
+
+static bool pixel(const uint8_t* buf, int x, int y) {
+    return buf[y * STRIDE + x / 8] & (0x80 >> (x & 7));
+}
+
+// Per-pixel reference for diffBits
+static BitsDiff diffReference(const uint8_t* a, const uint8_t* b, uint16_t* tileFlips) {
+    BitsDiff d = { INT16_MAX, -1, INT16_MAX, -1 };
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < STRIDE * 8; x++) {
+            if (pixel(a, x, y) == pixel(b, x, y)) continue;
+            d.rowMin = std::min<int16_t>(d.rowMin, y);
+            d.rowMax = std::max<int16_t>(d.rowMax, y);
+            d.colMin = std::min<int16_t>(d.colMin, x / 8);
+            d.colMax = std::max<int16_t>(d.colMax, x / 8);
+            tileFlips[(y / TILE) * TILE_COLS + x / TILE]++;
+        }
+    }
+    return d;
+}
+
+static void expectSameDiff(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    const uint8_t* pa = (const uint8_t*)a.data();
+    const uint8_t* pb = (const uint8_t*)b.data();
+    uint16_t flips[TILE_COLS * TILE_ROWS] = {};
+    uint16_t expectedFlips[TILE_COLS * TILE_ROWS] = {};
+
+    const BitsDiff d        = diffBits(pa, pb, BYTES, STRIDE, TILE, TILE_COLS, flips);
+    const BitsDiff expected = diffReference(pa, pb, expectedFlips);
+
+    EXPECT_EQ(expected.empty(), d.empty());
+    if (!expected.empty()) {
+        EXPECT_EQ(expected.rowMin, d.rowMin);
+        EXPECT_EQ(expected.rowMax, d.rowMax);
+        EXPECT_EQ(expected.colMin, d.colMin);
+        EXPECT_EQ(expected.colMax, d.colMax);
+    }
+    for (int i = 0; i < TILE_COLS * TILE_ROWS; i++)
+        EXPECT_EQ(expectedFlips[i], flips[i]) << "tile " << i;
+}
+
+static void flip(std::vector<uint32_t>& buf, int x, int y) {
+    ((uint8_t*)buf.data())[y * STRIDE + x / 8] ^= 0x80 >> (x & 7);
+}
+
+TEST(eink_bits, DiffOfIdenticalBuffersIsEmpty) {
+    std::mt19937 rng(1);
+    std::vector<uint32_t> a(BYTES / 4);
+    for (auto& w : a) w = rng();
+    std::vector<uint32_t> b = a;
+
+    uint16_t flips[TILE_COLS * TILE_ROWS] = {};
+    EXPECT_TRUE(diffBits((const uint8_t*)a.data(), (const uint8_t*)b.data(), BYTES, STRIDE, TILE,
+                         TILE_COLS, flips).empty());
+    for (uint16_t f : flips) EXPECT_EQ(0, f);
+}
+
+TEST(eink_bits, DiffOfSinglePixelsMatchesReference) {
+    // Corners, and pixels at the ends of words that straddle two rows
+    const int points[][2] = { {0, 0}, {239, 0}, {0, 319}, {239, 319}, {31, 1}, {32, 1},
+                              {16, 0}, {15, 1}, {119, 160}, {120, 160}, {39, 39}, {40, 40} };
+    for (const auto& p : points) {
+        std::vector<uint32_t> a(BYTES / 4, 0);
+        std::vector<uint32_t> b = a;
+        flip(b, p[0], p[1]);
+        SCOPED_TRACE(testing::Message() << "pixel " << p[0] << "," << p[1]);
+        expectSameDiff(a, b);
+    }
+}
+
+TEST(eink_bits, DiffOfRandomChangesMatchesReference) {
+    std::mt19937 rng(36);
+    for (int round = 0; round < 50; round++) {
+        std::vector<uint32_t> a(BYTES / 4);
+        for (auto& w : a) w = rng();
+        std::vector<uint32_t> b = a;
+
+        const int count = rng() % 200;
+        for (int i = 0; i < count; i++) flip(b, rng() % (STRIDE * 8), rng() % HEIGHT);
+        SCOPED_TRACE(testing::Message() << "round " << round);
+        expectSameDiff(a, b);
+    }
+}
+
+TEST(eink_bits, Transpose8MatchesReference) {
+    std::mt19937 rng(8);
+    for (int round = 0; round < 1000; round++) {
+        uint8_t in[8], out[8];
+        for (auto& v : in) v = rng();
+        // Fixed patterns first: empty, full, one bit per row, a single corner
+        if (round == 0) for (auto& v : in) v = 0x00;
+        if (round == 1) for (auto& v : in) v = 0xFF;
+        if (round == 2) for (int r = 0; r < 8; r++) in[r] = 0x80 >> r;
+        if (round == 3) { for (auto& v : in) v = 0; in[7] = 0x01; }
+
+        transpose8(in, out);
+        for (int k = 0; k < 8; k++) {
+            for (int r = 0; r < 8; r++) {
+                const bool expected = in[r] & (0x80 >> k);
+                EXPECT_EQ(expected, (out[k] & (0x80 >> r)) != 0) << "row " << r << " column " << k;
+            }
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Packs the e-ink images listed in assets/manifest.csv into one compressed blob.
+
+Runs before every PlatformIO build (extra_scripts = pre:tools/pack_assets.py) and can be
+run by hand. Writes:
+  lib/PocketMage/include/asset_ids.h     ASSET_* ids, in manifest order (checked in)
+  lib/PocketMage/src/asset_pack_data.cpp ASSET_INDEX and ASSET_DATA (generated, not checked in)
+Files are only rewritten when their content changes, so unchanged assets cost no rebuild.
+
+Each image is raw 1bpp (MSB first, 1 = black, rows padded to whole bytes), the same bytes
+image2cpp exports and drawBitmap takes. It is stored in whichever format is smallest: as is,
+PackBits-compressed, or with each row XORed with the one above before PackBits (line art
+with long vertical edges turns into mostly zero rows). Entries with scope "os" are left empty
+in OTA app builds, keeping their id.
+"""
+
+import argparse
+import sys
+from pathlib import Path
+
+try:
+    Import("env")  # noqa: F821 (provided by PlatformIO)
+except NameError:
+    env = None
+
+
+def packbits(data: bytes) -> bytes:
+    """PackBits: n < 128 -> n + 1 literals, n > 128 -> next byte repeated 257 - n times."""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out.append(257 - run)
+            out.append(data[i])
+            i += run
+            continue
+
+        start = i
+        while i < n and i - start < 128:
+            if i + 1 < n and data[i] == data[i + 1]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return bytes(out)
+
+
+def xor_rows(data: bytes, row_bytes: int) -> bytes:
+    out = bytearray(data)
+    for i in range(row_bytes, len(data)):
+        out[i] ^= data[i - row_bytes]
+    return bytes(out)
+
+
+# Must match AssetFormat in asset_pack.h
+ASSET_RAW, ASSET_PACKBITS, ASSET_PACKBITS_DELTA = range(3)
+
+
+def read_manifest(path: Path):
+    entries = []
+    for lineno, line in enumerate(path.read_text().splitlines(), 1):
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+        fields = [f.strip() for f in line.split(",")]
+        if len(fields) != 5 or fields[4] not in ("lib", "os"):
+            sys.exit(f"{path}:{lineno}: expected 'id, file, width, height, lib|os'")
+        entries.append((fields[0], fields[1], int(fields[2]), int(fields[3]), fields[4]))
+    return entries
+
+
+def write_if_changed(path: Path, text: str) -> bool:
+    if path.exists() and path.read_text() == text:
+        return False
+    path.write_text(text)
+    return True
+
+
+def ids_header(entries) -> str:
+    lines = [
+        "#pragma once",
+        "// Generated by tools/pack_assets.py from assets/manifest.csv, do not edit",
+        "#include <stdint.h>",
+        "",
+        "enum AssetId : uint16_t {",
+    ]
+    lines += [f"  ASSET_{name}," for name, *_ in entries]
+    lines += ["  ASSET_COUNT", "};", ""]
+    return "\n".join(lines)
+
+
+def pack_source(entries, assets_dir: Path, ota: bool):
+    index = []
+    blob = bytearray()
+    raw_total = 0
+    for name, file, width, height, scope in entries:
+        size = (width + 7) // 8 * height
+        if ota and scope == "os":
+            index.append((name, len(blob), 0, width, height, ASSET_RAW))
+            continue
+
+        raw = (assets_dir / file).read_bytes()
+        if len(raw) != size:
+            sys.exit(f"{file}: expected {size} bytes for {width}x{height}, got {len(raw)}")
+        candidates = [
+            (raw, ASSET_RAW),
+            (packbits(raw), ASSET_PACKBITS),
+            (packbits(xor_rows(raw, (width + 7) // 8)), ASSET_PACKBITS_DELTA),
+        ]
+        data, fmt = min(candidates, key=lambda c: len(c[0]))
+        index.append((name, len(blob), len(data), width, height, fmt))
+        blob += data
+        raw_total += size
+
+    lines = [
+        "// Generated by tools/pack_assets.py from assets/manifest.csv, do not edit",
+        "#include <asset_pack.h>",
+        "",
+        "const AssetEntry ASSET_INDEX[ASSET_COUNT] PROGMEM = {",
+    ]
+    lines += [f"  {{ {off:6}, {size:5}, {w:3}, {h:3}, {fmt} }},  // {name}"
+              for name, off, size, w, h, fmt in index]
+    lines += ["};", "", "const uint8_t ASSET_DATA[] PROGMEM = {"]
+    data = bytes(blob) or b"\x00"
+    for i in range(0, len(data), 16):
+        lines.append("  " + " ".join(f"0x{b:02x}," for b in data[i:i + 16]))
+    lines += ["};", ""]
+    return "\n".join(lines), raw_total, len(blob)
+
+
+def pack(project_dir: Path, ota: bool) -> None:
+    assets_dir = project_dir / "assets"
+    entries = read_manifest(assets_dir / "manifest.csv")
+    source, raw_total, packed_total = pack_source(entries, assets_dir, ota)
+
+    lib = project_dir / "lib" / "PocketMage"
+    changed = write_if_changed(lib / "include" / "asset_ids.h", ids_header(entries))
+    changed |= write_if_changed(lib / "src" / "asset_pack_data.cpp", source)
+    if changed:
+        print(f"Packed {len(entries)} assets: {raw_total} -> {packed_total} bytes")
+
+
+def build_flags(env) -> str:
+    flags = env.GetProjectOption("build_flags", "")
+    return " ".join(flags) if isinstance(flags, list) else flags
+
+
+if env is not None:
+    pack(Path(env.subst("$PROJECT_DIR")), "OTA_APP_FLAG=1" in build_flags(env))
+elif __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--ota", action="store_true", help="pack for an OTA app build")
+    args = parser.parse_args()
+    pack(Path(__file__).resolve().parent.parent, args.ota)